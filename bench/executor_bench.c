@@ -0,0 +1,215 @@
+/*
+ * This code is distributed under the terms of the GNU General Public License.
+ * For more information, please refer to the LICENSE file in the root directory.
+ * -------------------------------------------------
+ * Copyright (C) 2025 Rodrigo R.
+ * This program comes with ABSOLUTELY NO WARRANTY; for details type show w'.
+ * This is free software, and you are welcome to redistribute it
+ * under certain conditions; type show c' for details.
+*/
+
+// ============= EXECUTOR THROUGHPUT BENCHMARK =============
+// Compares the work-stealing executor with the pool most services hand-roll:
+// one linked queue guarded by a mutex and a condition variable. Two loads:
+//   - flat:   the main thread submits every task
+//   - fanout: the main thread submits parents, each parent submits FANOUT
+//             children from inside the pool
+//
+// Usage: linked_queue_executor_bench [threads] [tasks]
+
+#include "../linked_queue_executor.h"
+#include <stdio.h>
+
+#define FANOUT 64
+#define TASK_SPIN 64
+
+DEFINE_LINKED_QUEUE(linked_queue_task_t, bench_task);
+
+typedef struct
+{
+    linked_bench_task_queue_t queue;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    pthread_t *threads;
+    size_t thread_count;
+    bool stopping;
+} naive_pool_t;
+
+typedef struct
+{
+    bool (*submit)(void *pool, linked_queue_task_fn fn, void *arg);
+    void *pool;
+} bench_target_t;
+
+static atomic_size_t completed;
+static bench_target_t target;
+
+static void *naive_worker(void *arg)
+{
+    naive_pool_t *pool = arg;
+    for (;;)
+    {
+        linked_queue_task_t task;
+        pthread_mutex_lock(&pool->lock);
+        while (!pool->queue.next && !pool->stopping)
+        {
+            pthread_cond_wait(&pool->cond, &pool->lock);
+        }
+
+        const bool taken = linked_bench_task_queue_pop(&pool->queue, &task);
+        pthread_mutex_unlock(&pool->lock);
+
+        if (!taken)
+        {
+            return NULL;
+        }
+
+        task.fn(task.arg);
+    }
+}
+
+static bool naive_submit(void *arg, const linked_queue_task_fn fn, void *task_arg)
+{
+    naive_pool_t *pool = arg;
+    const linked_queue_task_t task = { fn, task_arg };
+    pthread_mutex_lock(&pool->lock);
+    const bool queued = linked_bench_task_queue_append(&pool->queue, task);
+    pthread_cond_signal(&pool->cond);
+    pthread_mutex_unlock(&pool->lock);
+    return queued;
+}
+
+static bool naive_init(naive_pool_t *pool, const size_t thread_count)
+{
+    linked_bench_task_queue_init(&pool->queue);
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->cond, NULL);
+    pool->stopping = FALSE;
+    pool->thread_count = thread_count;
+    pool->threads = malloc(thread_count * sizeof(pthread_t));
+    if (!pool->threads)
+    {
+        return FALSE;
+    }
+
+    for (size_t i = 0; i < thread_count; i++)
+    {
+        pthread_create(&pool->threads[i], NULL, naive_worker, pool);
+    }
+
+    return TRUE;
+}
+
+/* Drains the queue, then joins the workers */
+static void naive_shutdown(naive_pool_t *pool)
+{
+    pthread_mutex_lock(&pool->lock);
+    pool->stopping = TRUE;
+    pthread_cond_broadcast(&pool->cond);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (size_t i = 0; i < pool->thread_count; i++)
+    {
+        pthread_join(pool->threads[i], NULL);
+    }
+
+    free(pool->threads);
+    pthread_cond_destroy(&pool->cond);
+    pthread_mutex_destroy(&pool->lock);
+}
+
+static bool executor_submit(void *pool, const linked_queue_task_fn fn, void *arg)
+{
+    return linked_queue_executor_submit(pool, fn, arg);
+}
+
+static void leaf_task(void *arg)
+{
+    (void)arg;
+    for (volatile int i = 0; i < TASK_SPIN; i++)
+    {
+    }
+
+    atomic_fetch_add_explicit(&completed, 1, memory_order_relaxed);
+}
+
+static void parent_task(void *arg)
+{
+    (void)arg;
+    for (size_t i = 0; i < FANOUT; i++)
+    {
+        target.submit(target.pool, leaf_task, NULL);
+    }
+}
+
+/* Waits until `expected` leaves ran; the pools stay up so nested submits are never rejected */
+static void wait_for(const size_t expected)
+{
+    while (atomic_load_explicit(&completed, memory_order_relaxed) < expected)
+    {
+        sched_yield();
+    }
+}
+
+static double run_load(const bool fanout, const size_t tasks)
+{
+    atomic_store(&completed, 0);
+    const uint64_t start = linked_queue_now_ns();
+    if (fanout)
+    {
+        for (size_t i = 0; i < tasks / FANOUT; i++)
+        {
+            target.submit(target.pool, parent_task, NULL);
+        }
+
+        wait_for(tasks / FANOUT * FANOUT);
+    }
+    else
+    {
+        for (size_t i = 0; i < tasks; i++)
+        {
+            target.submit(target.pool, leaf_task, NULL);
+        }
+
+        wait_for(tasks);
+    }
+
+    const double seconds = (double)(linked_queue_now_ns() - start) / 1e9;
+    return (double)atomic_load(&completed) / seconds / 1e6;
+}
+
+int main(const int argc, char **argv)
+{
+    const size_t threads = argc > 1 ? strtoul(argv[1], NULL, 10) : 4;
+    const size_t tasks = argc > 2 ? strtoul(argv[2], NULL, 10) : 1000000;
+    if (!threads || tasks < FANOUT)
+    {
+        fprintf(stderr, "usage: %s [threads] [tasks >= %d]\n", argv[0], FANOUT);
+        return 1;
+    }
+
+    printf("%zu threads, %zu tasks, %d spin iterations per task\n", threads, tasks, TASK_SPIN);
+
+    naive_pool_t naive;
+    if (!naive_init(&naive, threads))
+    {
+        return 1;
+    }
+
+    target = (bench_target_t){ naive_submit, &naive };
+    printf("%-16s flat   %8.2f Mtasks/s\n", "mutex pool", run_load(FALSE, tasks));
+    printf("%-16s fanout %8.2f Mtasks/s\n", "mutex pool", run_load(TRUE, tasks));
+    naive_shutdown(&naive);
+
+    linked_queue_executor_t executor;
+    if (!linked_queue_executor_init(&executor, threads))
+    {
+        return 1;
+    }
+
+    target = (bench_target_t){ executor_submit, &executor };
+    printf("%-16s flat   %8.2f Mtasks/s\n", "work stealing", run_load(FALSE, tasks));
+    printf("%-16s fanout %8.2f Mtasks/s\n", "work stealing", run_load(TRUE, tasks));
+    linked_queue_executor_shutdown(&executor);
+    return 0;
+}
@@ -0,0 +1,133 @@
+/*
+ * This code is distributed under the terms of the GNU General Public License.
+ * For more information, please refer to the LICENSE file in the root directory.
+ * -------------------------------------------------
+ * Copyright (C) 2025 Rodrigo R.
+ * This program comes with ABSOLUTELY NO WARRANTY; for details type show w'.
+ * This is free software, and you are welcome to redistribute it
+ * under certain conditions; type show c' for details.
+*/
+
+// ============= PMR ALLOCATION BENCHMARK =============
+// Times `emplace_back` on the C++ linked queue with three node sources:
+//   - malloc:     the default `std::allocator`
+//   - pool:       `fluent::pmr::linked_queue` over `unsynchronized_pool_resource`
+//   - monotonic:  `fluent::pmr::linked_queue` over `monotonic_buffer_resource`,
+//                 released wholesale after each round
+// Each round fills a fresh queue, then tears it down; append and teardown
+// are reported separately, in nanoseconds per element.
+//
+// Usage: linked_queue_pmr_bench [elements] [rounds]
+
+#include "../linked_queue.hpp"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#ifndef FLUENT_LINKED_QUEUE_HAS_PMR
+int main()
+{
+    std::fprintf(stderr, "this standard library has no <memory_resource>\n");
+    return 1;
+}
+#else
+
+namespace
+{
+    struct bench_result
+    {
+        double append_ns;
+        double teardown_ns;
+    };
+
+    std::uint64_t elapsed_ns(const std::chrono::steady_clock::time_point start)
+    {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    // `make_queue` builds an empty queue; `after_round` runs once it is destroyed
+    template <typename MakeQueue, typename AfterRound>
+    bench_result run(const std::size_t elements, const std::size_t rounds, MakeQueue make_queue, AfterRound after_round)
+    {
+        std::uint64_t append = 0;
+        std::uint64_t teardown = 0;
+        std::uint64_t checksum = 0;
+
+        for (std::size_t r = 0; r < rounds; r++)
+        {
+            {
+                auto queue = make_queue();
+                auto start = std::chrono::steady_clock::now();
+                for (std::size_t i = 0; i < elements; i++)
+                {
+                    queue.emplace_back(static_cast<std::uint64_t>(i));
+                }
+
+                append += elapsed_ns(start);
+                checksum += queue.back();
+
+                start = std::chrono::steady_clock::now();
+                queue.clear();
+                teardown += elapsed_ns(start);
+            }
+
+            after_round();
+        }
+
+        // Keeps the loop from being optimized away
+        if (checksum == 0 && elements > 1)
+        {
+            std::fprintf(stderr, "unexpected checksum\n");
+        }
+
+        const double total = static_cast<double>(elements) * static_cast<double>(rounds);
+        return { static_cast<double>(append) / total, static_cast<double>(teardown) / total };
+    }
+
+    void report(const char *name, const bench_result result)
+    {
+        std::printf("%-10s append %7.2f ns/element   teardown %7.2f ns/element\n", name, result.append_ns, result.teardown_ns);
+    }
+}
+
+int main(const int argc, char **argv)
+{
+    const std::size_t elements = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    const std::size_t rounds = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 50;
+    if (!elements || !rounds)
+    {
+        std::fprintf(stderr, "usage: %s [elements] [rounds]\n", argv[0]);
+        return 1;
+    }
+
+    std::printf("%zu elements, %zu rounds\n", elements, rounds);
+
+    report("malloc", run(elements, rounds, []
+    {
+        return fluent::linked_queue<std::uint64_t>();
+    }, []
+    {
+    }));
+
+    std::pmr::unsynchronized_pool_resource pool;
+    report("pool", run(elements, rounds, [&pool]
+    {
+        return fluent::pmr::linked_queue<std::uint64_t>(&pool);
+    }, []
+    {
+    }));
+
+    std::pmr::monotonic_buffer_resource arena;
+    report("monotonic", run(elements, rounds, [&arena]
+    {
+        return fluent::pmr::linked_queue<std::uint64_t>(&arena);
+    }, [&arena]
+    {
+        arena.release();
+    }));
+
+    return 0;
+}
+
+#endif
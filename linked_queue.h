@@ -18,8 +18,15 @@
 // typed nodes, including utility functions for:
 //   - Initializing a queue
 //   - Appending elements to the tail
-//   - Prepending elements to the head
+//   - Prepending elements right after the head
 //   - Advancing the head to the next node (dequeue-like behavior)
+//   - Popping the first element while keeping the head node in place
+//   - Sorting the elements in place (stable merge sort)
+//   - Filtering or partitioning the elements in place by a predicate
+//   - Splitting off a suffix or the newest half into another queue
+//   - Searching and counting elements with a comparator
+//   - Mapping or reducing over the elements (serial `_parallel_*` fallback)
+//   - Iterating over the elements without consuming them
 //   - Freeing the entire queue
 //
 // Usage:
@@ -36,22 +43,32 @@
 //   linked_int_queue_append(queue, 42);
 //   linked_int_queue_append(queue, 1337);
 //
-//   while (queue && queue->size > 0) {
-//       printf("Value: %d\n", queue->data);
-//       linked_int_queue_next(&queue);
+//   int value;
+//   while (linked_int_queue_pop(queue, &value)) {
+//       printf("Value: %d\n", value);
 //   }
 //
 //   linked_int_queue_free(queue);
 //
 // Memory Management:
 //   - The caller must `malloc` the initial head node manually.
+//   - The head node is a sentinel: elements start at `head->next`, and
+//     `head->size`/`head->tail` describe them. `_prepend` inserts after it
+//     and, unlike earlier versions, never changes `*head_ptr`.
 //   - Internal nodes are `malloc`'d as needed; `linked_*_queue_free()` reclaims memory.
 //
 // Dependencies:
-//   - `types.h`, `std_bool.h` (from Fluent Lib C), and <stdlib.h>
+//   - `types.h`, `std_bool.h` (from Fluent Lib C), <stdlib.h>, <stdatomic.h> and <pthread.h>
+//   - POSIX.1-2008 (`clock_gettime`, `CLOCK_MONOTONIC`). Under a strict `-std=c11`
+//     the header requests it itself, which only works if it is included before
+//     any system header; otherwise define `_POSIX_C_SOURCE` on the command line.
 //
 
 // ============= INCLUDES =============
+#if defined(__STRICT_ANSI__) && !defined(_POSIX_C_SOURCE) && !defined(_GNU_SOURCE)
+    // Strict ISO modes (-std=c11) hide clock_gettime and the monotonic condvar clock
+#   define _POSIX_C_SOURCE 200809L
+#endif
 #ifndef FLUENT_LIBC_RELEASE
 #    include <types.h>
 #    include <std_bool.h>
@@ -59,7 +76,139 @@
 #   include <fluent/types/types.h>
 #   include <fluent/std_bool/std_bool.h>
 #endif
+#include <stddef.h>
 #include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <time.h>
+#ifdef __linux__
+#   include <sys/eventfd.h>
+#   include <unistd.h>
+#endif
+
+// ============= SHARED HELPERS =============
+#ifndef LINKED_QUEUE_CACHE_LINE
+#   define LINKED_QUEUE_CACHE_LINE 64
+#endif
+
+#ifndef LINKED_QUEUE_NODE_CACHE_LIMIT
+    // Free nodes kept per thread and queue type; 0 disables node caching
+#   define LINKED_QUEUE_NODE_CACHE_LIMIT 256
+#endif
+
+#ifndef LINKED_QUEUE_SPIN_LIMIT
+    // Busy-wait iterations before a spinning thread starts yielding
+#   define LINKED_QUEUE_SPIN_LIMIT 128
+#endif
+
+/* Monotonic clock reading in nanoseconds, used for deadlines and timeouts */
+static inline uint64_t linked_queue_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/* Deadline `timeout` ns from now, saturating at UINT64_MAX, which callers treat as "wait forever" */
+static inline uint64_t linked_queue_deadline_after(uint64_t timeout)
+{
+    const uint64_t now = linked_queue_now_ns();
+    return timeout >= UINT64_MAX - now ? UINT64_MAX : now + timeout;
+}
+
+/* Finalizer from splitmix64; a ready-made hash for integer and pointer keys */
+static inline size_t linked_queue_hash_u64(uint64_t x)
+{
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebull;
+    x ^= x >> 31;
+    return (size_t)x;
+}
+
+/* Creates the non-blocking eventfd used to drive queues from epoll loops, or returns -1 */
+static inline int linked_queue_event_open(void)
+{
+#ifdef __linux__
+    return eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+#else
+    return -1;
+#endif
+}
+
+static inline void linked_queue_event_signal(int fd)
+{
+#ifdef __linux__
+    const uint64_t one = 1;
+    ssize_t written = write(fd, &one, sizeof(one));
+    (void)written;
+#else
+    (void)fd;
+#endif
+}
+
+/* Clears the readable state; a no-op if nothing was signalled */
+static inline void linked_queue_event_reset(int fd)
+{
+#ifdef __linux__
+    uint64_t count;
+    ssize_t read_bytes = read(fd, &count, sizeof(count));
+    (void)read_bytes;
+#else
+    (void)fd;
+#endif
+}
+
+static inline void linked_queue_event_close(int fd)
+{
+#ifdef __linux__
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+#else
+    (void)fd;
+#endif
+}
+
+/* Initializes a condition variable whose timed waits use the monotonic clock */
+static inline bool linked_queue_cond_init(pthread_cond_t *cond)
+{
+    pthread_condattr_t attr;
+    if (pthread_condattr_init(&attr) != 0)
+    {
+        return FALSE;
+    }
+
+#ifndef __APPLE__
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+#endif
+    const bool ok = pthread_cond_init(cond, &attr) == 0;
+    pthread_condattr_destroy(&attr);
+    return ok;
+}
+
+/* Waits on a condition created by linked_queue_cond_init; returns FALSE once `deadline` has passed */
+static inline bool linked_queue_cond_wait_until(pthread_cond_t *cond, pthread_mutex_t *lock, uint64_t deadline)
+{
+#ifdef __APPLE__
+    const uint64_t now = linked_queue_now_ns();
+    if (now >= deadline)
+    {
+        return FALSE;
+    }
+
+    const uint64_t remaining = deadline - now;
+    struct timespec ts = { (time_t)(remaining / 1000000000ull), (long)(remaining % 1000000000ull) };
+    return pthread_cond_timedwait_relative_np(cond, lock, &ts) == 0;
+#else
+    struct timespec ts = { (time_t)(deadline / 1000000000ull), (long)(deadline % 1000000000ull) };
+    return pthread_cond_timedwait(cond, lock, &ts) == 0;
+#endif
+}
 
 // ============= TYPED LINKED QUEUE MACRO =============
 #define DEFINE_LINKED_QUEUE(V, NAME)                              \
@@ -135,27 +284,334 @@
                                                                   \
         linked_##NAME##_queue_t *head = *head_ptr;                \
                                                                   \
+        /* The head is a sentinel; the new element goes right after it */ \
         linked_##NAME##_queue_init(new_node);                     \
         new_node->data = data;                                    \
-        new_node->tail = head->tail;                              \
-        new_node->size = head->size + 1;                          \
+        new_node->next = head->next;                              \
+        head->next = new_node;                                    \
+        if (!head->tail)                                          \
+        {                                                         \
+            head->tail = new_node;                                \
+        }                                                         \
                                                                   \
-        head->tail = NULL;                                        \
-        head->size = 0;                                           \
-        new_node->next = head;                                    \
-        *head_ptr = new_node;                                     \
+        head->size++;                                             \
         return TRUE;                                              \
     }                                                             \
                                                                   \
-    static inline void linked_##NAME##_queue_free(linked_##NAME##_queue_t *head) \
+    static inline bool linked_##NAME##_queue_pop(linked_##NAME##_queue_t *head, V *out) \
+    {                                                             \
+        if (!head || !head->next)                                 \
+        {                                                         \
+            return FALSE;                                         \
+        }                                                         \
+                                                                  \
+        linked_##NAME##_queue_t *first = head->next;              \
+        if (out)                                                  \
+        {                                                         \
+            *out = first->data;                                   \
+        }                                                         \
+                                                                  \
+        head->next = first->next;                                 \
+        if (head->tail == first)                                  \
+        {                                                         \
+            head->tail = NULL;                                    \
+        }                                                         \
+                                                                  \
+        head->size--;                                             \
+        free(first);                                              \
+        return TRUE;                                              \
+    }                                                             \
+                                                                  \
+    /* Merges two sorted chains; ties keep the left element first */ \
+    static inline linked_##NAME##_queue_t *linked_##NAME##_queue_merge_(linked_##NAME##_queue_t *left, linked_##NAME##_queue_t *right, int (*cmp)(V const *a, V const *b), linked_##NAME##_queue_t **tail) \
+    {                                                             \
+        linked_##NAME##_queue_t merged;                           \
+        linked_##NAME##_queue_t *last = &merged;                  \
+                                                                  \
+        while (left && right)                                     \
+        {                                                         \
+            if (cmp(&right->data, &left->data) < 0)               \
+            {                                                     \
+                last->next = right;                               \
+                right = right->next;                              \
+            }                                                     \
+            else                                                  \
+            {                                                     \
+                last->next = left;                                \
+                left = left->next;                                \
+            }                                                     \
+                                                                  \
+            last = last->next;                                    \
+        }                                                         \
+                                                                  \
+        last->next = left ? left : right;                         \
+        while (last->next)                                        \
+        {                                                         \
+            last = last->next;                                    \
+        }                                                         \
+                                                                  \
+        *tail = last;                                             \
+        return merged.next;                                       \
+    }                                                             \
+                                                                  \
+    /* Stable, allocation-free bottom-up merge sort of the elements after the head */ \
+    static inline void linked_##NAME##_queue_sort(linked_##NAME##_queue_t *head, int (*cmp)(V const *a, V const *b)) \
+    {                                                             \
+        if (!head || !cmp || head->size < 2 || !head->next)       \
+        {                                                         \
+            return;                                               \
+        }                                                         \
+                                                                  \
+        linked_##NAME##_queue_t *list = head->next;               \
+        linked_##NAME##_queue_t *tail = NULL;                     \
+                                                                  \
+        for (size_t width = 1; width < head->size; width <<= 1)   \
+        {                                                         \
+            linked_##NAME##_queue_t sorted;                       \
+            linked_##NAME##_queue_t *last = &sorted;              \
+            linked_##NAME##_queue_t *rest = list;                 \
+                                                                  \
+            while (rest)                                          \
+            {                                                     \
+                linked_##NAME##_queue_t *left = rest;             \
+                linked_##NAME##_queue_t *cut = left;              \
+                for (size_t i = 1; i < width && cut->next; i++)   \
+                {                                                 \
+                    cut = cut->next;                              \
+                }                                                 \
+                                                                  \
+                linked_##NAME##_queue_t *right = cut->next;       \
+                cut->next = NULL;                                 \
+                rest = NULL;                                      \
+                if (right)                                        \
+                {                                                 \
+                    cut = right;                                  \
+                    for (size_t i = 1; i < width && cut->next; i++) \
+                    {                                             \
+                        cut = cut->next;                          \
+                    }                                             \
+                                                                  \
+                    rest = cut->next;                             \
+                    cut->next = NULL;                             \
+                }                                                 \
+                                                                  \
+                last->next = linked_##NAME##_queue_merge_(left, right, cmp, &tail); \
+                last = tail;                                      \
+            }                                                     \
+                                                                  \
+            list = sorted.next;                                   \
+        }                                                         \
+                                                                  \
+        head->next = list;                                        \
+        head->tail = tail;                                        \
+    }                                                             \
+    /* Unlinks every element matching `pred` in one pass; matches are appended to `out_other` or freed */ \
+    static inline size_t linked_##NAME##_queue_extract_(linked_##NAME##_queue_t *head, bool (*pred)(V const *data, void *ctx), void *ctx, linked_##NAME##_queue_t *out_other) \
+    {                                                             \
+        if (!head || !pred)                                       \
+        {                                                         \
+            return 0;                                             \
+        }                                                         \
+                                                                  \
+        linked_##NAME##_queue_t *prev = head;                     \
+        linked_##NAME##_queue_t *current = head->next;            \
+        size_t matched = 0;                                       \
+                                                                  \
+        while (current)                                           \
+        {                                                         \
+            linked_##NAME##_queue_t *next_node = current->next;   \
+            if (!pred(&current->data, ctx))                       \
+            {                                                     \
+                prev = current;                                   \
+                current = next_node;                              \
+                continue;                                         \
+            }                                                     \
+                                                                  \
+            prev->next = next_node;                               \
+            matched++;                                            \
+            if (out_other)                                        \
+            {                                                     \
+                current->next = NULL;                             \
+                if (!out_other->tail)                             \
+                {                                                 \
+                    out_other->tail = out_other;                  \
+                }                                                 \
+                                                                  \
+                out_other->tail->next = current;                  \
+                out_other->tail = current;                        \
+                out_other->size++;                                \
+            }                                                     \
+            else                                                  \
+            {                                                     \
+                free(current);                                    \
+            }                                                     \
+                                                                  \
+            current = next_node;                                  \
+        }                                                         \
+                                                                  \
+        head->size -= matched;                                    \
+        head->tail = head->size ? prev : NULL;                    \
+        return matched;                                           \
+    }                                                             \
+                                                                  \
+    /* Frees every element matching `pred`, keeping the rest in order */ \
+    static inline size_t linked_##NAME##_queue_remove_if(linked_##NAME##_queue_t *head, bool (*pred)(V const *data, void *ctx), void *ctx) \
+    {                                                             \
+        return linked_##NAME##_queue_extract_(head, pred, ctx, NULL); \
+    }                                                             \
+                                                                  \
+    /* Moves every element matching `pred` to the end of `out_other`, keeping both sides in order */ \
+    static inline size_t linked_##NAME##_queue_partition(linked_##NAME##_queue_t *head, bool (*pred)(V const *data, void *ctx), void *ctx, linked_##NAME##_queue_t *out_other) \
+    {                                                             \
+        if (!out_other)                                           \
+        {                                                         \
+            return 0;                                             \
+        }                                                         \
+                                                                  \
+        return linked_##NAME##_queue_extract_(head, pred, ctx, out_other); \
+    }                                                             \
+    /* Keeps the first `k` elements and splices the rest onto the end of `out` */ \
+    static inline size_t linked_##NAME##_queue_split_at(linked_##NAME##_queue_t *head, size_t k, linked_##NAME##_queue_t *out) \
+    {                                                             \
+        if (!head || !out || k >= head->size)                     \
+        {                                                         \
+            return 0;                                             \
+        }                                                         \
+                                                                  \
+        linked_##NAME##_queue_t *cut = head;                      \
+        for (size_t i = 0; i < k; i++)                            \
+        {                                                         \
+            cut = cut->next;                                      \
+        }                                                         \
+                                                                  \
+        const size_t moved = head->size - k;                      \
+        if (!out->tail)                                           \
+        {                                                         \
+            out->tail = out;                                      \
+        }                                                         \
+                                                                  \
+        out->tail->next = cut->next;                              \
+        out->tail = head->tail;                                   \
+        out->size += moved;                                       \
+                                                                  \
+        cut->next = NULL;                                         \
+        head->tail = k ? cut : NULL;                              \
+        head->size = k;                                           \
+        return moved;                                             \
+    }                                                             \
+                                                                  \
+    /* Moves the newest half of the elements to `out`, rounding down */ \
+    static inline size_t linked_##NAME##_queue_steal_half(linked_##NAME##_queue_t *head, linked_##NAME##_queue_t *out) \
     {                                                             \
         if (!head)                                                \
+        {                                                         \
+            return 0;                                             \
+        }                                                         \
+                                                                  \
+        return linked_##NAME##_queue_split_at(head, head->size - head->size / 2, out); \
+    }                                                             \
+                                                                  \
+    /* Returns the first element for which `cmp(element, &needle)` is 0, or NULL; `cmp` is the `_sort` comparator */ \
+    static inline V *linked_##NAME##_queue_find(const linked_##NAME##_queue_t *head, V needle, int (*cmp)(V const *a, V const *b)) \
+    {                                                             \
+        if (!cmp)                                                 \
+        {                                                         \
+            return NULL;                                          \
+        }                                                         \
+                                                                  \
+        for (const linked_##NAME##_queue_t *current = head ? head->next : NULL; current; current = current->next) \
+        {                                                         \
+            if (cmp(&current->data, &needle) == 0)                \
+            {                                                     \
+                return (V *)&current->data;                       \
+            }                                                     \
+        }                                                         \
+                                                                  \
+        return NULL;                                              \
+    }                                                             \
+                                                                  \
+    static inline size_t linked_##NAME##_queue_count(const linked_##NAME##_queue_t *head, V needle, int (*cmp)(V const *a, V const *b)) \
+    {                                                             \
+        size_t count = 0;                                         \
+        if (!cmp)                                                 \
+        {                                                         \
+            return 0;                                             \
+        }                                                         \
+                                                                  \
+        for (const linked_##NAME##_queue_t *current = head ? head->next : NULL; current; current = current->next) \
+        {                                                         \
+            count += cmp(&current->data, &needle) == 0;           \
+        }                                                         \
+                                                                  \
+        return count;                                             \
+    }                                                             \
+                                                                  \
+    static inline bool linked_##NAME##_queue_contains(const linked_##NAME##_queue_t *head, V needle, int (*cmp)(V const *a, V const *b)) \
+    {                                                             \
+        return linked_##NAME##_queue_find(head, needle, cmp) != NULL; \
+    }                                                             \
+                                                                  \
+    /* Serial fallback of the parallel API: calls `fn` on every element in order; `threads` is only a hint */ \
+    static inline void linked_##NAME##_queue_parallel_for_each(linked_##NAME##_queue_t *head, void (*fn)(V *data, void *ctx), void *ctx, size_t threads) \
+    {                                                             \
+        (void)threads;                                            \
+        if (!head || !fn)                                         \
         {                                                         \
             return;                                               \
         }                                                         \
                                                                   \
-        linked_##NAME##_queue_t *new_node = malloc(sizeof(linked_##NAME##_queue_t)); \
-        if (!new_node)                                            \
+        for (linked_##NAME##_queue_t *current = head->next; current; current = current->next) \
+        {                                                         \
+            fn(&current->data, ctx);                              \
+        }                                                         \
+    }                                                             \
+                                                                  \
+    /* Serial fallback of the parallel API: folds the elements in order with `op`, starting from `identity` */ \
+    static inline V linked_##NAME##_queue_parallel_reduce(const linked_##NAME##_queue_t *head, V (*op)(V acc, V data, void *ctx), V identity, void *ctx, size_t threads) \
+    {                                                             \
+        (void)threads;                                            \
+        V acc = identity;                                         \
+        if (!head || !op)                                         \
+        {                                                         \
+            return acc;                                           \
+        }                                                         \
+                                                                  \
+        for (const linked_##NAME##_queue_t *current = head->next; current; current = current->next) \
+        {                                                         \
+            acc = op(acc, current->data, ctx);                    \
+        }                                                         \
+                                                                  \
+        return acc;                                               \
+    }                                                             \
+                                                                  \
+    /* Read-only walk over the elements after the head, front to back */ \
+    typedef struct                                                \
+    {                                                             \
+        const linked_##NAME##_queue_t *node;                      \
+    } linked_##NAME##_queue_iter_t;                               \
+                                                                  \
+    static inline linked_##NAME##_queue_iter_t linked_##NAME##_queue_iter_begin(const linked_##NAME##_queue_t *head) \
+    {                                                             \
+        linked_##NAME##_queue_iter_t it = { head ? head->next : NULL }; \
+        return it;                                                \
+    }                                                             \
+                                                                  \
+    /* Returns the current element and advances, or NULL once exhausted */ \
+    static inline V const *linked_##NAME##_queue_iter_next(linked_##NAME##_queue_iter_t *it) \
+    {                                                             \
+        const linked_##NAME##_queue_t *node = it->node;           \
+        if (!node)                                                \
+        {                                                         \
+            return NULL;                                          \
+        }                                                         \
+                                                                  \
+        it->node = node->next;                                    \
+        return &node->data;                                       \
+    }                                                             \
+                                                                  \
+    static inline void linked_##NAME##_queue_free(linked_##NAME##_queue_t *head) \
+    {                                                             \
+        if (!head)                                                \
         {                                                         \
             return;                                               \
         }                                                         \
@@ -166,11 +622,2622 @@
         {                                                         \
             linked_##NAME##_queue_t *next_node = current->next;   \
             free(current);                                        \
+            current = next_node;                                  \
         }                                                         \
     }
 
+// ============= PER-THREAD NODE CACHE =============
+// Concurrent queues allocate nodes on producer threads and free them on
+// consumer threads, which defeats malloc's thread caches. A node cache keeps
+// a small free list per thread: nodes released by their owner go straight
+// back to it, while nodes released by any other thread are pushed onto the
+// owner's lock-free return list, which the owner reclaims in one exchange
+// the next time its local list runs dry.
+//
+// When a thread exits, its cache is retired: cached nodes are freed and
+// later remote releases fall back to free(). Nodes still sitting in queues
+// keep pointing at the cache, so its header is only freed once the last of
+// them has been released.
+typedef struct linked_queue_node_cache_t
+{
+    void *local;
+    size_t local_count;
+    size_t link_offset;
+    size_t issued;
+    size_t returned_local;
+    _Alignas(LINKED_QUEUE_CACHE_LINE) void *_Atomic remote;
+    atomic_llong balance;
+    atomic_bool alive;
+} linked_queue_node_cache_t;
+
+// A thread's handle on its cache for one queue type. Once the thread-exit
+// destructor has retired the cache, `retired` keeps later calls made during
+// the same exit (other key destructors, C++ thread_local destructors) on
+// plain malloc/free instead of a freed or freshly leaked cache.
+typedef struct
+{
+    linked_queue_node_cache_t *cache;
+    bool retired;
+} linked_queue_node_cache_slot_t;
+
+static inline void **linked_queue_node_link_(void *node, size_t link_offset)
+{
+    return (void **)((char *)node + link_offset);
+}
+
+/* `link_offset` is the offset of a pointer field in the node reused as the free-list link */
+static inline linked_queue_node_cache_t *linked_queue_node_cache_create(size_t link_offset)
+{
+    linked_queue_node_cache_t *cache = aligned_alloc(LINKED_QUEUE_CACHE_LINE, sizeof(linked_queue_node_cache_t));
+    if (!cache)
+    {
+        return NULL;
+    }
+
+    cache->local = NULL;
+    cache->local_count = 0;
+    cache->link_offset = link_offset;
+    cache->issued = 0;
+    cache->returned_local = 0;
+    atomic_init(&cache->remote, NULL);
+    atomic_init(&cache->balance, 0);
+    atomic_init(&cache->alive, TRUE);
+    return cache;
+}
+
+/* Frees the nodes returned after retirement and the cache itself */
+static inline void linked_queue_node_cache_destroy_(linked_queue_node_cache_t *cache)
+{
+    void *node = atomic_exchange_explicit(&cache->remote, NULL, memory_order_acquire);
+    while (node)
+    {
+        void *next = *linked_queue_node_link_(node, cache->link_offset);
+        free(node);
+        node = next;
+    }
+
+    free(cache);
+}
+
+/* Takes a node from the calling thread's cache, falling back to malloc */
+static inline void *linked_queue_node_cache_alloc(linked_queue_node_cache_t *cache, size_t size)
+{
+    if (!cache || !LINKED_QUEUE_NODE_CACHE_LIMIT)
+    {
+        return malloc(size);
+    }
+
+    cache->issued++;
+    if (!cache->local && atomic_load_explicit(&cache->remote, memory_order_relaxed))
+    {
+        // Keep at most LINKED_QUEUE_NODE_CACHE_LIMIT of the returned chain; free the overflow
+        void **link = &cache->local;
+        void *node = atomic_exchange_explicit(&cache->remote, NULL, memory_order_acquire);
+        while (node && cache->local_count < LINKED_QUEUE_NODE_CACHE_LIMIT)
+        {
+            *link = node;
+            link = linked_queue_node_link_(node, cache->link_offset);
+            node = *link;
+            cache->local_count++;
+        }
+
+        *link = NULL;
+        while (node)
+        {
+            void *next = *linked_queue_node_link_(node, cache->link_offset);
+            free(node);
+            node = next;
+        }
+    }
+
+    void *node = cache->local;
+    if (!node)
+    {
+        return malloc(size);
+    }
+
+    cache->local = *linked_queue_node_link_(node, cache->link_offset);
+    cache->local_count--;
+    return node;
+}
+
+/* Returns a node to the cache that allocated it; `current` is the calling thread's cache */
+static inline void linked_queue_node_cache_free(linked_queue_node_cache_t *owner, linked_queue_node_cache_t *current, void *node)
+{
+    if (!owner || !LINKED_QUEUE_NODE_CACHE_LIMIT)
+    {
+        free(node);
+        return;
+    }
+
+    if (owner == current)
+    {
+        owner->returned_local++;
+        if (owner->local_count >= LINKED_QUEUE_NODE_CACHE_LIMIT)
+        {
+            free(node);
+            return;
+        }
+
+        *linked_queue_node_link_(node, owner->link_offset) = owner->local;
+        owner->local = node;
+        owner->local_count++;
+        return;
+    }
+
+    if (atomic_load_explicit(&owner->alive, memory_order_acquire))
+    {
+        void *head = atomic_load_explicit(&owner->remote, memory_order_relaxed);
+        do
+        {
+            *linked_queue_node_link_(node, owner->link_offset) = head;
+        } while (!atomic_compare_exchange_weak_explicit(&owner->remote, &head, node, memory_order_release, memory_order_relaxed));
+    }
+    else
+    {
+        free(node);
+    }
+
+    // Balance only turns positive once the owner has retired; reaching zero means no node is left
+    if (atomic_fetch_sub_explicit(&owner->balance, 1, memory_order_acq_rel) == 1)
+    {
+        linked_queue_node_cache_destroy_(owner);
+    }
+}
+
+/* Thread-exit destructor: frees every cached node and stops accepting returns */
+static inline void linked_queue_node_cache_retire(void *arg)
+{
+    linked_queue_node_cache_t *cache = arg;
+    atomic_store_explicit(&cache->alive, FALSE, memory_order_release);
+
+    void *node = cache->local;
+    while (node)
+    {
+        void *next = *linked_queue_node_link_(node, cache->link_offset);
+        free(node);
+        node = next;
+    }
+
+    node = atomic_exchange_explicit(&cache->remote, NULL, memory_order_acquire);
+    while (node)
+    {
+        void *next = *linked_queue_node_link_(node, cache->link_offset);
+        free(node);
+        node = next;
+    }
+
+    cache->local = NULL;
+    cache->local_count = 0;
+
+    const long long outstanding = (long long)(cache->issued - cache->returned_local);
+    if (atomic_fetch_add_explicit(&cache->balance, outstanding, memory_order_acq_rel) + outstanding == 0)
+    {
+        linked_queue_node_cache_destroy_(cache);
+    }
+}
+
+// ============= QUEUE WAIT SET =============
+// Lets one consumer block until any of several bounded queues (of any value
+// type) becomes ready, i.e. non-empty or closed. Queues joined to a wait set
+// bump its shared notification sequence whenever they go from empty to
+// non-empty or are closed. A waiter scans the queues and sleeps on the set
+// while holding the set lock across both, so no wakeup can be lost between
+// scan and sleep.
+//
+// Usage:
+//   - Join each queue with bounded_name_queue_join_waitset(queue, &set); a
+//     queue belongs to at most one set at a time.
+//   - linked_queue_waitset_wait(&set, timeout) returns the index of a ready
+//     queue, or -1 on timeout. A closed queue stays ready, so leave the set
+//     with bounded_name_queue_leave_waitset once it is drained.
+//   - Free the set only after every queue has left it. Leaving waits for
+//     notifies already in flight, so the set is then no longer touched.
+typedef struct
+{
+    void *queue;
+    bool (*ready)(void *queue);
+} linked_queue_waitset_entry_t;
+
+typedef struct linked_queue_waitset_t
+{
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    uint64_t sequence;
+    linked_queue_waitset_entry_t *entries;
+    size_t count;
+    size_t next;
+} linked_queue_waitset_t;
+
+static inline bool linked_queue_waitset_init(linked_queue_waitset_t *set)
+{
+    if (pthread_mutex_init(&set->lock, NULL) != 0)
+    {
+        return FALSE;
+    }
+
+    if (!linked_queue_cond_init(&set->cond))
+    {
+        pthread_mutex_destroy(&set->lock);
+        return FALSE;
+    }
+
+    set->sequence = 0;
+    set->entries = NULL;
+    set->count = 0;
+    set->next = 0;
+    return TRUE;
+}
+
+/* Registers a type-erased queue, reusing a vacated slot; returns its index, or -1 on allocation failure */
+static inline int linked_queue_waitset_add(linked_queue_waitset_t *set, void *queue, bool (*ready)(void *queue))
+{
+    pthread_mutex_lock(&set->lock);
+    size_t index = 0;
+    while (index < set->count && set->entries[index].queue)
+    {
+        index++;
+    }
+
+    if (index == set->count)
+    {
+        linked_queue_waitset_entry_t *entries = realloc(set->entries, (set->count + 1) * sizeof(linked_queue_waitset_entry_t));
+        if (!entries)
+        {
+            pthread_mutex_unlock(&set->lock);
+            return -1;
+        }
+
+        set->entries = entries;
+        set->count++;
+    }
+
+    set->entries[index].queue = queue;
+    set->entries[index].ready = ready;
+    set->sequence++;
+    pthread_cond_broadcast(&set->cond);
+    pthread_mutex_unlock(&set->lock);
+    return (int)index;
+}
+
+/* Unregisters a queue; once this returns, no waiter touches it again. Other indices stay valid */
+static inline bool linked_queue_waitset_remove(linked_queue_waitset_t *set, const void *queue)
+{
+    pthread_mutex_lock(&set->lock);
+    for (size_t i = 0; i < set->count; i++)
+    {
+        if (set->entries[i].queue == queue)
+        {
+            set->entries[i].queue = NULL;
+            set->entries[i].ready = NULL;
+            pthread_mutex_unlock(&set->lock);
+            return TRUE;
+        }
+    }
+
+    pthread_mutex_unlock(&set->lock);
+    return FALSE;
+}
+
+static inline void linked_queue_waitset_notify(linked_queue_waitset_t *set)
+{
+    pthread_mutex_lock(&set->lock);
+    set->sequence++;
+    pthread_cond_broadcast(&set->cond);
+    pthread_mutex_unlock(&set->lock);
+}
+
+/* Blocks until a registered queue is ready and returns its index; -1 once `timeout` ns pass */
+static inline int linked_queue_waitset_wait(linked_queue_waitset_t *set, uint64_t timeout)
+{
+    const uint64_t deadline = linked_queue_deadline_after(timeout);
+
+    // Queues notify with their own lock released, so probing them under the set lock cannot deadlock
+    pthread_mutex_lock(&set->lock);
+    for (;;)
+    {
+        const uint64_t seen = set->sequence;
+        for (size_t i = 0; i < set->count; i++)
+        {
+            const size_t index = (set->next + i) % set->count;
+            const linked_queue_waitset_entry_t entry = set->entries[index];
+            if (entry.queue && entry.ready(entry.queue))
+            {
+                set->next = index + 1;
+                pthread_mutex_unlock(&set->lock);
+                return (int)index;
+            }
+        }
+
+        bool timed_out = FALSE;
+        while (set->sequence == seen && !timed_out)
+        {
+            if (deadline == UINT64_MAX)
+            {
+                pthread_cond_wait(&set->cond, &set->lock);
+            }
+            else if (!linked_queue_cond_wait_until(&set->cond, &set->lock, deadline))
+            {
+                timed_out = linked_queue_now_ns() >= deadline;
+            }
+        }
+
+        if (timed_out)
+        {
+            pthread_mutex_unlock(&set->lock);
+            return -1;
+        }
+    }
+}
+
+static inline void linked_queue_waitset_free(linked_queue_waitset_t *set)
+{
+    free(set->entries);
+    set->entries = NULL;
+    set->count = 0;
+    pthread_cond_destroy(&set->cond);
+    pthread_mutex_destroy(&set->lock);
+}
+
+// ============= BOUNDED LINKED QUEUE =============
+// A thread-safe wrapper around a typed linked queue that enforces a capacity,
+// either in elements or in bytes. When the queue is full, `_append` behaves
+// according to the overflow policy:
+//   - LINKED_QUEUE_OVERFLOW_REJECT:      return FALSE immediately
+//   - LINKED_QUEUE_OVERFLOW_BLOCK:       wait until a consumer frees space
+//   - LINKED_QUEUE_OVERFLOW_DROP_OLDEST: discard elements from the head
+// `_append_many` applies the same policy element by element, but links the
+// whole batch and wakes consumers under a single lock acquisition.
+//
+// High/low watermark callbacks let upstream stages pause when usage reaches
+// the high mark and resume once it falls back to the low mark, without
+// polling `size`. Callbacks run after the internal lock has been released,
+// one at a time and in crossing order, so `on_high` and `on_low` strictly
+// alternate and the last one delivered matches the current state.
+//
+// Nodes come from a per-thread cache (see PER-THREAD NODE CACHE), so a
+// producer reuses the nodes its consumers have already released.
+//
+// On Linux, `_attach_eventfd` returns an eventfd that becomes readable when
+// the queue goes from empty to non-empty and is cleared when it is drained,
+// so the queue can sit in an epoll set. Appends to a non-empty queue do not
+// touch the eventfd, so a burst of appends costs a single write().
+//
+// Usage:
+//   - DEFINE_BOUNDED_LINKED_QUEUE(ValueType, name) requires a prior
+//     DEFINE_LINKED_QUEUE(ValueType, name).
+//   - A capacity of 0 means unbounded; the queue is then only a blocking
+//     synchronized FIFO.
+typedef enum
+{
+    LINKED_QUEUE_OVERFLOW_REJECT = 0,
+    LINKED_QUEUE_OVERFLOW_BLOCK,
+    LINKED_QUEUE_OVERFLOW_DROP_OLDEST
+} linked_queue_overflow_t;
+
+typedef enum
+{
+    LINKED_QUEUE_CAPACITY_ELEMENTS = 0,
+    LINKED_QUEUE_CAPACITY_BYTES
+} linked_queue_capacity_unit_t;
+
+typedef void (*linked_queue_watermark_fn)(void *queue, size_t usage, void *ctx);
+
+#define DEFINE_BOUNDED_LINKED_QUEUE(V, NAME)                      \
+    typedef struct bounded_##NAME##_queue_t                       \
+    {                                                             \
+        linked_##NAME##_queue_t queue;                            \
+        pthread_mutex_t lock;                                     \
+        pthread_cond_t not_empty;                                 \
+        pthread_cond_t not_full;                                  \
+        size_t capacity;                                          \
+        size_t usage;                                             \
+        size_t (*measure)(V const *data);                         \
+        linked_queue_capacity_unit_t unit;                        \
+        linked_queue_overflow_t policy;                           \
+        size_t high_watermark;                                    \
+        size_t low_watermark;                                     \
+        linked_queue_watermark_fn on_high;                        \
+        linked_queue_watermark_fn on_low;                         \
+        void *watermark_ctx;                                      \
+        bool above_high;                                          \
+        bool delivered_high;                                      \
+        bool delivering;                                          \
+        bool closed;                                              \
+        size_t batch_waiters;                                     \
+        int event_fd;                                             \
+        bool event_armed;                                         \
+        linked_queue_waitset_t *waitset;                          \
+        atomic_size_t waitset_notifiers;                          \
+        size_t dropped;                                           \
+        size_t peak;                                              \
+    } bounded_##NAME##_queue_t;                                   \
+                                                                  \
+    static inline pthread_key_t *bounded_##NAME##_queue_cache_key_(void) \
+    {                                                             \
+        static pthread_key_t key;                                 \
+        return &key;                                              \
+    }                                                             \
+                                                                  \
+    static inline linked_queue_node_cache_slot_t *bounded_##NAME##_queue_cache_slot_(void) \
+    {                                                             \
+        static _Thread_local linked_queue_node_cache_slot_t slot = { NULL, FALSE }; \
+        return &slot;                                             \
+    }                                                             \
+                                                                  \
+    /* Thread-exit destructor; later calls on this thread bypass the cache */ \
+    static inline void bounded_##NAME##_queue_cache_retire_(void *cache) \
+    {                                                             \
+        linked_queue_node_cache_slot_t *slot = bounded_##NAME##_queue_cache_slot_(); \
+        linked_queue_node_cache_retire(cache);                    \
+        slot->cache = NULL;                                       \
+        slot->retired = TRUE;                                     \
+    }                                                             \
+                                                                  \
+    static inline void bounded_##NAME##_queue_cache_key_init_(void) \
+    {                                                             \
+        pthread_key_create(bounded_##NAME##_queue_cache_key_(), bounded_##NAME##_queue_cache_retire_); \
+    }                                                             \
+                                                                  \
+    /* Node cache of the calling thread for this queue type, created on first use; NULL once retired */ \
+    static inline linked_queue_node_cache_t *bounded_##NAME##_queue_node_cache_(void) \
+    {                                                             \
+        linked_queue_node_cache_slot_t *slot = bounded_##NAME##_queue_cache_slot_(); \
+        static pthread_once_t once = PTHREAD_ONCE_INIT;           \
+        if (!slot->cache && !slot->retired)                       \
+        {                                                         \
+            pthread_once(&once, bounded_##NAME##_queue_cache_key_init_); \
+            slot->cache = linked_queue_node_cache_create(offsetof(linked_##NAME##_queue_t, next)); \
+            if (slot->cache)                                      \
+            {                                                     \
+                pthread_setspecific(*bounded_##NAME##_queue_cache_key_(), slot->cache); \
+            }                                                     \
+        }                                                         \
+                                                                  \
+        return slot->cache;                                       \
+    }                                                             \
+                                                                  \
+    /* Nodes inside a bounded queue never act as a head, so `tail` records the owning cache */ \
+    static inline linked_##NAME##_queue_t *bounded_##NAME##_queue_node_acquire_(void) \
+    {                                                             \
+        linked_queue_node_cache_t *cache = bounded_##NAME##_queue_node_cache_(); \
+        linked_##NAME##_queue_t *node = linked_queue_node_cache_alloc(cache, sizeof(linked_##NAME##_queue_t)); \
+        if (node)                                                 \
+        {                                                         \
+            node->tail = (linked_##NAME##_queue_t *)cache;        \
+        }                                                         \
+                                                                  \
+        return node;                                              \
+    }                                                             \
+                                                                  \
+    static inline void bounded_##NAME##_queue_node_release_(linked_##NAME##_queue_t *node) \
+    {                                                             \
+        linked_queue_node_cache_free((linked_queue_node_cache_t *)node->tail, bounded_##NAME##_queue_node_cache_(), node); \
+    }                                                             \
+                                                                  \
+    static inline bool bounded_##NAME##_queue_init(bounded_##NAME##_queue_t *q, size_t capacity, linked_queue_capacity_unit_t unit, linked_queue_overflow_t policy) \
+    {                                                             \
+        if (!q)                                                   \
+        {                                                         \
+            return FALSE;                                         \
+        }                                                         \
+                                                                  \
+        linked_##NAME##_queue_init(&q->queue);                    \
+        if (pthread_mutex_init(&q->lock, NULL) != 0)              \
+        {                                                         \
+            return FALSE;                                         \
+        }                                                         \
+                                                                  \
+        if (!linked_queue_cond_init(&q->not_empty))               \
+        {                                                         \
+            pthread_mutex_destroy(&q->lock);                      \
+            return FALSE;                                         \
+        }                                                         \
+                                                                  \
+        if (!linked_queue_cond_init(&q->not_full))                \
+        {                                                         \
+            pthread_cond_destroy(&q->not_empty);                  \
+            pthread_mutex_destroy(&q->lock);                      \
+            return FALSE;                                         \
+        }                                                         \
+                                                                  \
+        q->capacity = capacity;                                   \
+        q->usage = 0;                                             \
+        q->measure = NULL;                                        \
+        q->unit = unit;                                           \
+        q->policy = policy;                                       \
+        q->high_watermark = 0;                                    \
+        q->low_watermark = 0;                                     \
+        q->on_high = NULL;                                        \
+        q->on_low = NULL;                                         \
+        q->watermark_ctx = NULL;                                  \
+        q->above_high = FALSE;                                    \
+        q->delivered_high = FALSE;                                \
+        q->delivering = FALSE;                                    \
+        q->closed = FALSE;                                        \
+        q->batch_waiters = 0;                                     \
+        q->event_fd = -1;                                         \
+        q->event_armed = FALSE;                                   \
+        q->waitset = NULL;                                        \
+        atomic_init(&q->waitset_notifiers, 0);                    \
+        q->dropped = 0;                                           \
+        q->peak = 0;                                              \
+        return TRUE;                                              \
+    }                                                             \
+                                                                  \
+    /* Applies to elements appended from now on; queued elements keep the cost they were charged */ \
+    static inline void bounded_##NAME##_queue_set_measure(bounded_##NAME##_queue_t *q, size_t (*measure)(V const *data)) \
+    {                                                             \
+        pthread_mutex_lock(&q->lock);                             \
+        q->measure = measure;                                     \
+        pthread_mutex_unlock(&q->lock);                           \
+    }                                                             \
+                                                                  \
+    static inline void bounded_##NAME##_queue_set_watermarks(bounded_##NAME##_queue_t *q, size_t high, size_t low, linked_queue_watermark_fn on_high, linked_queue_watermark_fn on_low, void *ctx) \
+    {                                                             \
+        pthread_mutex_lock(&q->lock);                             \
+        q->high_watermark = high;                                 \
+        q->low_watermark = low < high ? low : high;               \
+        q->on_high = on_high;                                     \
+        q->on_low = on_low;                                       \
+        q->watermark_ctx = ctx;                                   \
+        q->above_high = FALSE;                                    \
+        q->delivered_high = FALSE;                                \
+        pthread_mutex_unlock(&q->lock);                           \
+    }                                                             \
+                                                                  \
+    static inline size_t bounded_##NAME##_queue_cost_(const bounded_##NAME##_queue_t *q, V const *data) \
+    {                                                             \
+        if (q->unit == LINKED_QUEUE_CAPACITY_ELEMENTS)            \
+        {                                                         \
+            return 1;                                             \
+        }                                                         \
+                                                                  \
+        return sizeof(linked_##NAME##_queue_t) + (q->measure ? q->measure(data) : 0); \
+    }                                                             \
+                                                                  \
+    /* Returns 1 if the high mark was crossed, -1 for the low mark, 0 otherwise */ \
+    static inline int bounded_##NAME##_queue_watermark_(bounded_##NAME##_queue_t *q) \
+    {                                                             \
+        if (!q->high_watermark)                                   \
+        {                                                         \
+            return 0;                                             \
+        }                                                         \
+                                                                  \
+        if (!q->above_high && q->usage >= q->high_watermark)      \
+        {                                                         \
+            q->above_high = TRUE;                                 \
+            return 1;                                             \
+        }                                                         \
+                                                                  \
+        if (q->above_high && q->usage <= q->low_watermark)        \
+        {                                                         \
+            q->above_high = FALSE;                                \
+            return -1;                                            \
+        }                                                         \
+                                                                  \
+        return 0;                                                 \
+    }                                                             \
+                                                                  \
+    /* Delivers watermark callbacks outside the lock, one thread at a time, until they match `above_high` */ \
+    static inline void bounded_##NAME##_queue_notify_(bounded_##NAME##_queue_t *q, int crossed) \
+    {                                                             \
+        if (!crossed)                                             \
+        {                                                         \
+            return;                                               \
+        }                                                         \
+                                                                  \
+        pthread_mutex_lock(&q->lock);                             \
+        if (q->delivering)                                        \
+        {                                                         \
+            /* The delivering thread re-checks `above_high` before it stops */ \
+            pthread_mutex_unlock(&q->lock);                       \
+            return;                                               \
+        }                                                         \
+                                                                  \
+        q->delivering = TRUE;                                     \
+        while (q->delivered_high != q->above_high)                \
+        {                                                         \
+            const bool high = q->above_high;                      \
+            const size_t usage = q->usage;                        \
+            linked_queue_watermark_fn callback = high ? q->on_high : q->on_low; \
+            q->delivered_high = high;                             \
+            pthread_mutex_unlock(&q->lock);                       \
+                                                                  \
+            if (callback)                                         \
+            {                                                     \
+                callback(q, usage, q->watermark_ctx);             \
+            }                                                     \
+                                                                  \
+            pthread_mutex_lock(&q->lock);                         \
+        }                                                         \
+                                                                  \
+        q->delivering = FALSE;                                    \
+        pthread_mutex_unlock(&q->lock);                           \
+    }                                                             \
+                                                                  \
+    /* Removes the head element; the caller must hold the lock */ \
+    static inline bool bounded_##NAME##_queue_take_(bounded_##NAME##_queue_t *q, V *out) \
+    {                                                             \
+        linked_##NAME##_queue_t *first = q->queue.next;           \
+        if (!first)                                               \
+        {                                                         \
+            return FALSE;                                         \
+        }                                                         \
+                                                                  \
+        /* The cost recorded at link time, so a later set_measure cannot skew `usage` */ \
+        const size_t cost = first->size;                          \
+        if (out)                                                  \
+        {                                                         \
+            *out = first->data;                                   \
+        }                                                         \
+                                                                  \
+        q->queue.next = first->next;                              \
+        if (q->queue.tail == first)                               \
+        {                                                         \
+            q->queue.tail = NULL;                                 \
+        }                                                         \
+                                                                  \
+        q->queue.size--;                                          \
+        bounded_##NAME##_queue_node_release_(first);              \
+        q->usage -= cost;                                         \
+        pthread_cond_broadcast(&q->not_full);                     \
+        if (!q->queue.next && q->event_armed)                     \
+        {                                                         \
+            linked_queue_event_reset(q->event_fd);                \
+            q->event_armed = FALSE;                               \
+        }                                                         \
+        return TRUE;                                              \
+    }                                                             \
+                                                                  \
+    /* Links a node at the tail and records its cost in `size`; the caller must hold the lock and have made room */ \
+    static inline void bounded_##NAME##_queue_link_(bounded_##NAME##_queue_t *q, linked_##NAME##_queue_t *node, size_t cost) \
+    {                                                             \
+        if (!q->queue.tail)                                       \
+        {                                                         \
+            q->queue.tail = &q->queue;                            \
+        }                                                         \
+                                                                  \
+        node->size = cost;                                        \
+        q->queue.tail->next = node;                               \
+        q->queue.tail = node;                                     \
+        q->queue.size++;                                          \
+        q->usage += cost;                                         \
+        if (q->queue.size > q->peak)                              \
+        {                                                         \
+            q->peak = q->queue.size;                              \
+        }                                                         \
+    }                                                             \
+                                                                  \
+    /* Wakes consumers after linking; `many` when more than one element was linked */ \
+    static inline void bounded_##NAME##_queue_wake_(bounded_##NAME##_queue_t *q, bool many) \
+    {                                                             \
+        if (q->event_fd >= 0 && !q->event_armed)                  \
+        {                                                         \
+            linked_queue_event_signal(q->event_fd);               \
+            q->event_armed = TRUE;                                \
+        }                                                         \
+                                                                  \
+        if (many || q->batch_waiters)                             \
+        {                                                         \
+            /* Batch waiters may go back to sleep, so a single signal could be lost */ \
+            pthread_cond_broadcast(&q->not_empty);                \
+        }                                                         \
+        else                                                      \
+        {                                                         \
+            pthread_cond_signal(&q->not_empty);                   \
+        }                                                         \
+    }                                                             \
+                                                                  \
+    /* Reads the wait set and keeps it alive until _waitset_notify_; the caller must hold the lock */ \
+    static inline linked_queue_waitset_t *bounded_##NAME##_queue_waitset_pin_(bounded_##NAME##_queue_t *q) \
+    {                                                             \
+        linked_queue_waitset_t *set = q->waitset;                 \
+        if (set)                                                  \
+        {                                                         \
+            atomic_fetch_add_explicit(&q->waitset_notifiers, 1, memory_order_relaxed); \
+        }                                                         \
+                                                                  \
+        return set;                                               \
+    }                                                             \
+                                                                  \
+    /* Notifies a set pinned by _waitset_pin_ with the lock released, then unpins it */ \
+    static inline void bounded_##NAME##_queue_waitset_notify_(bounded_##NAME##_queue_t *q, linked_queue_waitset_t *set) \
+    {                                                             \
+        if (set)                                                  \
+        {                                                         \
+            linked_queue_waitset_notify(set);                     \
+            atomic_fetch_sub_explicit(&q->waitset_notifiers, 1, memory_order_release); \
+        }                                                         \
+    }                                                             \
+                                                                  \
+    static inline bool bounded_##NAME##_queue_append(bounded_##NAME##_queue_t *q, V data) \
+    {                                                             \
+        if (!q)                                                   \
+        {                                                         \
+            return FALSE;                                         \
+        }                                                         \
+                                                                  \
+        linked_##NAME##_queue_t *node = bounded_##NAME##_queue_node_acquire_(); \
+        if (!node)                                                \
+        {                                                         \
+            return FALSE;                                         \
+        }                                                         \
+                                                                  \
+        node->data = data;                                        \
+        node->next = NULL;                                        \
+        node->size = 0;                                           \
+        pthread_mutex_lock(&q->lock);                             \
+        const size_t cost = bounded_##NAME##_queue_cost_(q, &data); \
+        if (q->closed || (q->capacity && cost > q->capacity))     \
+        {                                                         \
+            pthread_mutex_unlock(&q->lock);                       \
+            bounded_##NAME##_queue_node_release_(node);           \
+            return FALSE;                                         \
+        }                                                         \
+                                                                  \
+        while (q->capacity && q->usage + cost > q->capacity)      \
+        {                                                         \
+            if (q->policy == LINKED_QUEUE_OVERFLOW_REJECT)        \
+            {                                                     \
+                pthread_mutex_unlock(&q->lock);                   \
+                bounded_##NAME##_queue_node_release_(node);       \
+                return FALSE;                                     \
+            }                                                     \
+                                                                  \
+            if (q->policy == LINKED_QUEUE_OVERFLOW_DROP_OLDEST)   \
+            {                                                     \
+                if (!bounded_##NAME##_queue_take_(q, NULL))       \
+                {                                                 \
+                    /* Nothing left to drop */                    \
+                    pthread_mutex_unlock(&q->lock);               \
+                    bounded_##NAME##_queue_node_release_(node);   \
+                    return FALSE;                                 \
+                }                                                 \
+                                                                  \
+                q->dropped++;                                     \
+                continue;                                         \
+            }                                                     \
+                                                                  \
+            pthread_cond_wait(&q->not_full, &q->lock);            \
+            if (q->closed)                                        \
+            {                                                     \
+                pthread_mutex_unlock(&q->lock);                   \
+                bounded_##NAME##_queue_node_release_(node);       \
+                return FALSE;                                     \
+            }                                                     \
+        }                                                         \
+                                                                  \
+        bounded_##NAME##_queue_link_(q, node, cost);              \
+        const int crossed = bounded_##NAME##_queue_watermark_(q); \
+        linked_queue_waitset_t *waitset = q->queue.size == 1 ? bounded_##NAME##_queue_waitset_pin_(q) : NULL; \
+        bounded_##NAME##_queue_wake_(q, FALSE);                   \
+        pthread_mutex_unlock(&q->lock);                           \
+                                                                  \
+        bounded_##NAME##_queue_waitset_notify_(q, waitset);       \
+        bounded_##NAME##_queue_notify_(q, crossed);               \
+        return TRUE;                                              \
+    }                                                             \
+                                                                  \
+    /* Appends up to `count` elements under one lock acquisition, applying the overflow policy to each; returns how many were queued */ \
+    static inline size_t bounded_##NAME##_queue_append_many(bounded_##NAME##_queue_t *q, V const *data, size_t count) \
+    {                                                             \
+        if (!q || !data || !count)                                \
+        {                                                         \
+            return 0;                                             \
+        }                                                         \
+                                                                  \
+        linked_##NAME##_queue_t *chain = NULL;                    \
+        linked_##NAME##_queue_t *chain_tail = NULL;               \
+        for (size_t i = 0; i < count; i++)                        \
+        {                                                         \
+            linked_##NAME##_queue_t *node = bounded_##NAME##_queue_node_acquire_(); \
+            if (!node)                                            \
+            {                                                     \
+                break;                                            \
+            }                                                     \
+                                                                  \
+            node->data = data[i];                                 \
+            node->next = NULL;                                    \
+            node->size = 0;                                       \
+            if (chain_tail)                                       \
+            {                                                     \
+                chain_tail->next = node;                          \
+            }                                                     \
+            else                                                  \
+            {                                                     \
+                chain = node;                                     \
+            }                                                     \
+                                                                  \
+            chain_tail = node;                                    \
+        }                                                         \
+                                                                  \
+        size_t appended = 0;                                      \
+        size_t unannounced = 0;                                   \
+        bool from_empty = FALSE;                                  \
+        int crossed = 0;                                          \
+        pthread_mutex_lock(&q->lock);                             \
+        while (chain)                                             \
+        {                                                         \
+            const size_t cost = bounded_##NAME##_queue_cost_(q, &chain->data); \
+            if (q->closed || (q->capacity && cost > q->capacity)) \
+            {                                                     \
+                break;                                            \
+            }                                                     \
+                                                                  \
+            if (q->capacity && q->usage + cost > q->capacity)     \
+            {                                                     \
+                if (q->policy == LINKED_QUEUE_OVERFLOW_REJECT)    \
+                {                                                 \
+                    break;                                        \
+                }                                                 \
+                                                                  \
+                if (q->policy == LINKED_QUEUE_OVERFLOW_DROP_OLDEST) \
+                {                                                 \
+                    if (!bounded_##NAME##_queue_take_(q, NULL))   \
+                    {                                             \
+                        /* Nothing left to drop */                \
+                        break;                                    \
+                    }                                             \
+                                                                  \
+                    q->dropped++;                                 \
+                    continue;                                     \
+                }                                                 \
+                                                                  \
+                if (unannounced)                                  \
+                {                                                 \
+                    /* Consumers must see what is linked so far before this thread sleeps on them */ \
+                    bounded_##NAME##_queue_wake_(q, TRUE);        \
+                    linked_queue_waitset_t *waitset = from_empty ? bounded_##NAME##_queue_waitset_pin_(q) : NULL; \
+                    unannounced = 0;                              \
+                    pthread_mutex_unlock(&q->lock);               \
+                                                                  \
+                    bounded_##NAME##_queue_waitset_notify_(q, waitset); \
+                    bounded_##NAME##_queue_notify_(q, crossed);   \
+                    crossed = 0;                                  \
+                    pthread_mutex_lock(&q->lock);                 \
+                    continue;                                     \
+                }                                                 \
+                                                                  \
+                pthread_cond_wait(&q->not_full, &q->lock);        \
+                continue;                                         \
+            }                                                     \
+                                                                  \
+            linked_##NAME##_queue_t *node = chain;                \
+            chain = node->next;                                   \
+            node->next = NULL;                                    \
+            if (!unannounced)                                     \
+            {                                                     \
+                from_empty = !q->queue.next;                      \
+            }                                                     \
+                                                                  \
+            bounded_##NAME##_queue_link_(q, node, cost);          \
+            const int node_crossed = bounded_##NAME##_queue_watermark_(q); \
+            crossed = node_crossed ? node_crossed : crossed;      \
+            appended++;                                           \
+            unannounced++;                                        \
+        }                                                         \
+                                                                  \
+        linked_queue_waitset_t *waitset = unannounced && from_empty ? bounded_##NAME##_queue_waitset_pin_(q) : NULL; \
+        if (unannounced)                                          \
+        {                                                         \
+            bounded_##NAME##_queue_wake_(q, unannounced > 1);     \
+        }                                                         \
+                                                                  \
+        pthread_mutex_unlock(&q->lock);                           \
+                                                                  \
+        /* Elements that could not be queued hand their nodes back */ \
+        while (chain)                                             \
+        {                                                         \
+            linked_##NAME##_queue_t *next_node = chain->next;     \
+            bounded_##NAME##_queue_node_release_(chain);          \
+            chain = next_node;                                    \
+        }                                                         \
+                                                                  \
+        bounded_##NAME##_queue_waitset_notify_(q, waitset);       \
+        bounded_##NAME##_queue_notify_(q, crossed);               \
+        return appended;                                          \
+    }                                                             \
+                                                                  \
+    static inline bool bounded_##NAME##_queue_pop(bounded_##NAME##_queue_t *q, V *out) \
+    {                                                             \
+        if (!q)                                                   \
+        {                                                         \
+            return FALSE;                                         \
+        }                                                         \
+                                                                  \
+        pthread_mutex_lock(&q->lock);                             \
+        const bool taken = bounded_##NAME##_queue_take_(q, out);  \
+        const int crossed = taken ? bounded_##NAME##_queue_watermark_(q) : 0; \
+        pthread_mutex_unlock(&q->lock);                           \
+                                                                  \
+        bounded_##NAME##_queue_notify_(q, crossed);               \
+        return taken;                                             \
+    }                                                             \
+                                                                  \
+    /* Blocks until an element is available; returns FALSE once closed and drained */ \
+    static inline bool bounded_##NAME##_queue_pop_wait(bounded_##NAME##_queue_t *q, V *out) \
+    {                                                             \
+        if (!q)                                                   \
+        {                                                         \
+            return FALSE;                                         \
+        }                                                         \
+                                                                  \
+        pthread_mutex_lock(&q->lock);                             \
+        while (!q->queue.next && !q->closed)                      \
+        {                                                         \
+            pthread_cond_wait(&q->not_empty, &q->lock);           \
+        }                                                         \
+                                                                  \
+        const bool taken = bounded_##NAME##_queue_take_(q, out);  \
+        const int crossed = taken ? bounded_##NAME##_queue_watermark_(q) : 0; \
+        pthread_mutex_unlock(&q->lock);                           \
+                                                                  \
+        bounded_##NAME##_queue_notify_(q, crossed);               \
+        return taken;                                             \
+    }                                                             \
+                                                                  \
+    /* Blocks until at least one element is available, then takes up to `max` under a single lock */ \
+    static inline size_t bounded_##NAME##_queue_pop_many(bounded_##NAME##_queue_t *q, V *out, size_t max) \
+    {                                                             \
+        if (!q || !out || !max)                                   \
+        {                                                         \
+            return 0;                                             \
+        }                                                         \
+                                                                  \
+        pthread_mutex_lock(&q->lock);                             \
+        while (!q->queue.next && !q->closed)                      \
+        {                                                         \
+            pthread_cond_wait(&q->not_empty, &q->lock);           \
+        }                                                         \
+                                                                  \
+        size_t taken = 0;                                         \
+        while (taken < max && bounded_##NAME##_queue_take_(q, &out[taken])) \
+        {                                                         \
+            taken++;                                              \
+        }                                                         \
+                                                                  \
+        const int crossed = taken ? bounded_##NAME##_queue_watermark_(q) : 0; \
+        pthread_mutex_unlock(&q->lock);                           \
+                                                                  \
+        bounded_##NAME##_queue_notify_(q, crossed);               \
+        return taken;                                             \
+    }                                                             \
+    /* Waits until `max` elements are queued or `max_wait` nanoseconds elapse (UINT64_MAX: no deadline), then takes up to `max` */ \
+    static inline size_t bounded_##NAME##_queue_pop_batch(bounded_##NAME##_queue_t *q, V *out, size_t max, uint64_t max_wait) \
+    {                                                             \
+        if (!q || !out || !max)                                   \
+        {                                                         \
+            return 0;                                             \
+        }                                                         \
+                                                                  \
+        const uint64_t deadline = linked_queue_deadline_after(max_wait); \
+        pthread_mutex_lock(&q->lock);                             \
+        q->batch_waiters++;                                       \
+        while (q->queue.size < max && !q->closed)                 \
+        {                                                         \
+            if (deadline == UINT64_MAX)                           \
+            {                                                     \
+                pthread_cond_wait(&q->not_empty, &q->lock);       \
+            }                                                     \
+            else if (!linked_queue_cond_wait_until(&q->not_empty, &q->lock, deadline) && linked_queue_now_ns() >= deadline) \
+            {                                                     \
+                break;                                            \
+            }                                                     \
+        }                                                         \
+                                                                  \
+        q->batch_waiters--;                                       \
+        size_t taken = 0;                                         \
+        while (taken < max && bounded_##NAME##_queue_take_(q, &out[taken])) \
+        {                                                         \
+            taken++;                                              \
+        }                                                         \
+                                                                  \
+        const int crossed = taken ? bounded_##NAME##_queue_watermark_(q) : 0; \
+        pthread_mutex_unlock(&q->lock);                           \
+                                                                  \
+        bounded_##NAME##_queue_notify_(q, crossed);               \
+        return taken;                                             \
+    }                                                             \
+    static inline size_t bounded_##NAME##_queue_size(bounded_##NAME##_queue_t *q) \
+    {                                                             \
+        pthread_mutex_lock(&q->lock);                             \
+        const size_t size = q->queue.size;                        \
+        pthread_mutex_unlock(&q->lock);                           \
+        return size;                                              \
+    }                                                             \
+                                                                  \
+    /* Largest number of elements queued at once since init */    \
+    static inline size_t bounded_##NAME##_queue_peak(bounded_##NAME##_queue_t *q) \
+    {                                                             \
+        pthread_mutex_lock(&q->lock);                             \
+        const size_t peak = q->peak;                              \
+        pthread_mutex_unlock(&q->lock);                           \
+        return peak;                                              \
+    }                                                             \
+    /* Returns an eventfd that stays readable while the queue is non-empty, or -1 */ \
+    static inline int bounded_##NAME##_queue_attach_eventfd(bounded_##NAME##_queue_t *q) \
+    {                                                             \
+        pthread_mutex_lock(&q->lock);                             \
+        if (q->event_fd < 0)                                      \
+        {                                                         \
+            q->event_fd = linked_queue_event_open();              \
+            if (q->event_fd >= 0 && q->queue.next)                \
+            {                                                     \
+                linked_queue_event_signal(q->event_fd);           \
+                q->event_armed = TRUE;                            \
+            }                                                     \
+        }                                                         \
+                                                                  \
+        const int fd = q->event_fd;                               \
+        pthread_mutex_unlock(&q->lock);                           \
+        return fd;                                                \
+    }                                                             \
+                                                                  \
+    /* Wait-set readiness: non-empty, or closed so the consumer learns about end-of-stream */ \
+    static inline bool bounded_##NAME##_queue_ready_erased_(void *erased) \
+    {                                                             \
+        bounded_##NAME##_queue_t *q = erased;                     \
+        pthread_mutex_lock(&q->lock);                             \
+        const bool ready = q->queue.next || q->closed;            \
+        pthread_mutex_unlock(&q->lock);                           \
+        return ready;                                             \
+    }                                                             \
+                                                                  \
+    /* Makes the queue notify `set` when it becomes ready; returns its index in the set, or -1 if already in a set */ \
+    static inline int bounded_##NAME##_queue_join_waitset(bounded_##NAME##_queue_t *q, linked_queue_waitset_t *set) \
+    {                                                             \
+        pthread_mutex_lock(&q->lock);                             \
+        if (q->waitset)                                           \
+        {                                                         \
+            pthread_mutex_unlock(&q->lock);                       \
+            return -1;                                            \
+        }                                                         \
+                                                                  \
+        q->waitset = set;                                         \
+        pthread_mutex_unlock(&q->lock);                           \
+                                                                  \
+        const int index = linked_queue_waitset_add(set, q, bounded_##NAME##_queue_ready_erased_); \
+        if (index < 0)                                            \
+        {                                                         \
+            pthread_mutex_lock(&q->lock);                         \
+            q->waitset = NULL;                                    \
+            pthread_mutex_unlock(&q->lock);                       \
+        }                                                         \
+                                                                  \
+        return index;                                             \
+    }                                                             \
+                                                                  \
+    /* Removes the queue from its wait set, if any; returns once no notify to it is in flight */ \
+    static inline void bounded_##NAME##_queue_leave_waitset(bounded_##NAME##_queue_t *q) \
+    {                                                             \
+        pthread_mutex_lock(&q->lock);                             \
+        linked_queue_waitset_t *set = q->waitset;                 \
+        q->waitset = NULL;                                        \
+        pthread_mutex_unlock(&q->lock);                           \
+                                                                  \
+        /* Notifiers pinned the set before it was cleared; none can pin it after */ \
+        while (atomic_load_explicit(&q->waitset_notifiers, memory_order_acquire)) \
+        {                                                         \
+            sched_yield();                                        \
+        }                                                         \
+                                                                  \
+        if (set)                                                  \
+        {                                                         \
+            linked_queue_waitset_remove(set, q);                  \
+        }                                                         \
+    }                                                             \
+                                                                  \
+    /* Wakes every blocked producer and consumer; further appends are rejected */ \
+    static inline void bounded_##NAME##_queue_close(bounded_##NAME##_queue_t *q) \
+    {                                                             \
+        pthread_mutex_lock(&q->lock);                             \
+        q->closed = TRUE;                                         \
+        linked_queue_waitset_t *waitset = bounded_##NAME##_queue_waitset_pin_(q); \
+        pthread_cond_broadcast(&q->not_empty);                    \
+        pthread_cond_broadcast(&q->not_full);                     \
+        pthread_mutex_unlock(&q->lock);                           \
+                                                                  \
+        bounded_##NAME##_queue_waitset_notify_(q, waitset);       \
+    }                                                             \
+                                                                  \
+    static inline void bounded_##NAME##_queue_free(bounded_##NAME##_queue_t *q) \
+    {                                                             \
+        if (!q)                                                   \
+        {                                                         \
+            return;                                               \
+        }                                                         \
+                                                                  \
+        bounded_##NAME##_queue_leave_waitset(q);                  \
+                                                                  \
+        linked_##NAME##_queue_t *current = q->queue.next;         \
+        while (current)                                           \
+        {                                                         \
+            linked_##NAME##_queue_t *next_node = current->next;   \
+            bounded_##NAME##_queue_node_release_(current);        \
+            current = next_node;                                  \
+        }                                                         \
+                                                                  \
+        linked_##NAME##_queue_init(&q->queue);                    \
+        linked_queue_event_close(q->event_fd);                    \
+        pthread_cond_destroy(&q->not_full);                       \
+        pthread_cond_destroy(&q->not_empty);                      \
+        pthread_mutex_destroy(&q->lock);                          \
+    }
+
+// ============= EXPIRING LINKED QUEUE =============
+// A linked queue whose elements carry a monotonic deadline. Expired elements
+// are never handed to the consumer: `_pop` unlinks every stale element in
+// front of the first live one in a single pass, and `_drain` reclaims them
+// while delivering the rest. The number of discarded elements is kept in
+// `expired` so overloaded consumers can report the load they shed.
+//
+// Usage:
+//   - DEFINE_EXPIRING_LINKED_QUEUE(ValueType, name) defines the entry type,
+//     the underlying linked queue and the expiring_*_queue_* functions.
+//   - A TTL or deadline of 0 means the element never expires.
+#define DEFINE_EXPIRING_LINKED_QUEUE(V, NAME)                     \
+    typedef struct                                                \
+    {                                                             \
+        V value;                                                  \
+        uint64_t deadline;                                        \
+    } expiring_##NAME##_entry_t;                                  \
+                                                                  \
+    DEFINE_LINKED_QUEUE(expiring_##NAME##_entry_t, expiring_##NAME) \
+                                                                  \
+    typedef struct expiring_##NAME##_queue_t                      \
+    {                                                             \
+        linked_expiring_##NAME##_queue_t queue;                   \
+        uint64_t default_ttl;                                     \
+        size_t expired;                                           \
+    } expiring_##NAME##_queue_t;                                  \
+                                                                  \
+    static inline void expiring_##NAME##_queue_init(expiring_##NAME##_queue_t *q, uint64_t default_ttl) \
+    {                                                             \
+        linked_expiring_##NAME##_queue_init(&q->queue);           \
+        q->default_ttl = default_ttl;                             \
+        q->expired = 0;                                           \
+    }                                                             \
+                                                                  \
+    static inline bool expiring_##NAME##_queue_append_deadline(expiring_##NAME##_queue_t *q, V data, uint64_t deadline) \
+    {                                                             \
+        if (!q)                                                   \
+        {                                                         \
+            return FALSE;                                         \
+        }                                                         \
+                                                                  \
+        expiring_##NAME##_entry_t entry;                          \
+        entry.value = data;                                       \
+        entry.deadline = deadline;                                \
+        return linked_expiring_##NAME##_queue_append(&q->queue, entry); \
+    }                                                             \
+                                                                  \
+    static inline bool expiring_##NAME##_queue_append_ttl(expiring_##NAME##_queue_t *q, V data, uint64_t ttl) \
+    {                                                             \
+        return expiring_##NAME##_queue_append_deadline(q, data, ttl ? linked_queue_deadline_after(ttl) : 0); \
+    }                                                             \
+                                                                  \
+    static inline bool expiring_##NAME##_queue_append(expiring_##NAME##_queue_t *q, V data) \
+    {                                                             \
+        return expiring_##NAME##_queue_append_ttl(q, data, q->default_ttl); \
+    }                                                             \
+                                                                  \
+    static inline bool expiring_##NAME##_queue_is_expired_(const expiring_##NAME##_entry_t *entry, uint64_t now) \
+    {                                                             \
+        return entry->deadline && entry->deadline <= now;         \
+    }                                                             \
+                                                                  \
+    static inline bool expiring_##NAME##_queue_pop(expiring_##NAME##_queue_t *q, V *out) \
+    {                                                             \
+        if (!q)                                                   \
+        {                                                         \
+            return FALSE;                                         \
+        }                                                         \
+                                                                  \
+        linked_expiring_##NAME##_queue_t *head = &q->queue;       \
+        linked_expiring_##NAME##_queue_t *current = head->next;   \
+        const uint64_t now = linked_queue_now_ns();               \
+        size_t dropped = 0;                                       \
+                                                                  \
+        while (current && expiring_##NAME##_queue_is_expired_(&current->data, now)) \
+        {                                                         \
+            linked_expiring_##NAME##_queue_t *next_node = current->next; \
+            free(current);                                        \
+            current = next_node;                                  \
+            dropped++;                                            \
+        }                                                         \
+                                                                  \
+        head->next = current;                                     \
+        head->size -= dropped;                                    \
+        q->expired += dropped;                                    \
+        if (!current)                                             \
+        {                                                         \
+            head->tail = NULL;                                    \
+            return FALSE;                                         \
+        }                                                         \
+                                                                  \
+        expiring_##NAME##_entry_t entry;                          \
+        linked_expiring_##NAME##_queue_pop(head, &entry);         \
+        if (out)                                                  \
+        {                                                         \
+            *out = entry.value;                                   \
+        }                                                         \
+                                                                  \
+        return TRUE;                                              \
+    }                                                             \
+                                                                  \
+    /* Hands every live element to `fn` in FIFO order and empties the queue */ \
+    static inline size_t expiring_##NAME##_queue_drain(expiring_##NAME##_queue_t *q, void (*fn)(V *data, void *ctx), void *ctx) \
+    {                                                             \
+        if (!q)                                                   \
+        {                                                         \
+            return 0;                                             \
+        }                                                         \
+                                                                  \
+        linked_expiring_##NAME##_queue_t *current = q->queue.next; \
+        const uint64_t now = linked_queue_now_ns();               \
+        size_t delivered = 0;                                     \
+                                                                  \
+        while (current)                                           \
+        {                                                         \
+            linked_expiring_##NAME##_queue_t *next_node = current->next; \
+            if (expiring_##NAME##_queue_is_expired_(&current->data, now)) \
+            {                                                     \
+                q->expired++;                                     \
+            }                                                     \
+            else                                                  \
+            {                                                     \
+                if (fn)                                           \
+                {                                                 \
+                    fn(&current->data.value, ctx);                \
+                }                                                 \
+                                                                  \
+                delivered++;                                      \
+            }                                                     \
+                                                                  \
+            free(current);                                        \
+            current = next_node;                                  \
+        }                                                         \
+                                                                  \
+        q->queue.next = NULL;                                     \
+        q->queue.tail = NULL;                                     \
+        q->queue.size = 0;                                        \
+        return delivered;                                         \
+    }                                                             \
+                                                                  \
+    static inline void expiring_##NAME##_queue_free(expiring_##NAME##_queue_t *q) \
+    {                                                             \
+        if (!q)                                                   \
+        {                                                         \
+            return;                                               \
+        }                                                         \
+                                                                  \
+        linked_expiring_##NAME##_queue_free(q->queue.next);       \
+        linked_expiring_##NAME##_queue_init(&q->queue);           \
+    }
+
+// ============= NODE HASH INDEX =============
+// An open-addressing (linear probing) hash table mapping keys to nodes of a
+// linked queue, used by the queue variants that need O(1) lookups. Deletion
+// uses backward shifting, so the table never accumulates tombstones.
+//
+// Usage:
+//   - DEFINE_LINKED_QUEUE_INDEX(KeyType, NodeType, name, key_of, hash, eq)
+//     where `key_of(const NodeType *)` extracts the key of a node,
+//     `hash(KeyType)` returns a size_t and `eq(KeyType, KeyType)` compares.
+#define DEFINE_LINKED_QUEUE_INDEX(K, NODE_T, NAME, KEY_OF, HASH, EQ) \
+    typedef struct NAME##_index_t                                 \
+    {                                                             \
+        NODE_T **slots;                                           \
+        size_t capacity;                                          \
+        size_t count;                                             \
+    } NAME##_index_t;                                             \
+                                                                  \
+    static inline void NAME##_index_init(NAME##_index_t *idx)     \
+    {                                                             \
+        idx->slots = NULL;                                        \
+        idx->capacity = 0;                                        \
+        idx->count = 0;                                           \
+    }                                                             \
+                                                                  \
+    static inline size_t NAME##_index_probe_(const NAME##_index_t *idx, K key) \
+    {                                                             \
+        const size_t mask = idx->capacity - 1;                    \
+        size_t i = HASH(key) & mask;                              \
+        while (idx->slots[i] && !EQ(KEY_OF(idx->slots[i]), key))  \
+        {                                                         \
+            i = (i + 1) & mask;                                   \
+        }                                                         \
+                                                                  \
+        return i;                                                 \
+    }                                                             \
+                                                                  \
+    /* Ensures room for `count` keys at a load factor of at most 3/4 */ \
+    static inline bool NAME##_index_reserve(NAME##_index_t *idx, size_t count) \
+    {                                                             \
+        if (count * 4 < idx->capacity * 3)                        \
+        {                                                         \
+            return TRUE;                                          \
+        }                                                         \
+                                                                  \
+        size_t capacity = idx->capacity ? idx->capacity : 16;     \
+        while (count * 4 >= capacity * 3)                         \
+        {                                                         \
+            capacity <<= 1;                                       \
+        }                                                         \
+                                                                  \
+        NODE_T **slots = calloc(capacity, sizeof(NODE_T *));      \
+        if (!slots)                                               \
+        {                                                         \
+            return FALSE;                                         \
+        }                                                         \
+                                                                  \
+        NAME##_index_t grown = { slots, capacity, idx->count };   \
+        for (size_t i = 0; i < idx->capacity; i++)                \
+        {                                                         \
+            if (idx->slots[i])                                    \
+            {                                                     \
+                slots[NAME##_index_probe_(&grown, KEY_OF(idx->slots[i]))] = idx->slots[i]; \
+            }                                                     \
+        }                                                         \
+                                                                  \
+        free(idx->slots);                                         \
+        *idx = grown;                                             \
+        return TRUE;                                              \
+    }                                                             \
+                                                                  \
+    static inline NODE_T *NAME##_index_find(const NAME##_index_t *idx, K key) \
+    {                                                             \
+        if (!idx->count)                                          \
+        {                                                         \
+            return NULL;                                          \
+        }                                                         \
+                                                                  \
+        return idx->slots[NAME##_index_probe_(idx, key)];         \
+    }                                                             \
+                                                                  \
+    /* Inserts or replaces the node stored under its key */       \
+    static inline bool NAME##_index_insert(NAME##_index_t *idx, NODE_T *node) \
+    {                                                             \
+        if (!NAME##_index_reserve(idx, idx->count + 1))           \
+        {                                                         \
+            return FALSE;                                         \
+        }                                                         \
+                                                                  \
+        const size_t i = NAME##_index_probe_(idx, KEY_OF(node));  \
+        if (!idx->slots[i])                                       \
+        {                                                         \
+            idx->count++;                                         \
+        }                                                         \
+                                                                  \
+        idx->slots[i] = node;                                     \
+        return TRUE;                                              \
+    }                                                             \
+                                                                  \
+    static inline bool NAME##_index_remove(NAME##_index_t *idx, K key) \
+    {                                                             \
+        if (!idx->count)                                          \
+        {                                                         \
+            return FALSE;                                         \
+        }                                                         \
+                                                                  \
+        const size_t mask = idx->capacity - 1;                    \
+        size_t hole = NAME##_index_probe_(idx, key);              \
+        if (!idx->slots[hole])                                    \
+        {                                                         \
+            return FALSE;                                         \
+        }                                                         \
+                                                                  \
+        /* Shift back every entry whose probe sequence crosses the hole */ \
+        size_t i = hole;                                          \
+        for (;;)                                                  \
+        {                                                         \
+            i = (i + 1) & mask;                                   \
+            if (!idx->slots[i])                                   \
+            {                                                     \
+                break;                                            \
+            }                                                     \
+                                                                  \
+            const size_t home = HASH(KEY_OF(idx->slots[i])) & mask; \
+            if (((i - home) & mask) >= ((i - hole) & mask))       \
+            {                                                     \
+                idx->slots[hole] = idx->slots[i];                 \
+                hole = i;                                         \
+            }                                                     \
+        }                                                         \
+                                                                  \
+        idx->slots[hole] = NULL;                                  \
+        idx->count--;                                             \
+        return TRUE;                                              \
+    }                                                             \
+                                                                  \
+    static inline void NAME##_index_free(NAME##_index_t *idx)     \
+    {                                                             \
+        free(idx->slots);                                         \
+        NAME##_index_init(idx);                                   \
+    }
+
+// ============= COALESCING LINKED QUEUE =============
+// A FIFO of key/value pairs where each key is pending at most once. Appending
+// a key that is already queued keeps its original position and either
+// replaces the pending value or combines both through a merge callback, so
+// the queue length is bounded by the number of distinct keys.
+//
+// Usage:
+//   - DEFINE_COALESCING_LINKED_QUEUE(KeyType, ValueType, name, hash, eq)
+//     where `hash(KeyType)` returns a size_t and `eq(KeyType, KeyType)`
+//     compares two keys.
+#define DEFINE_COALESCING_LINKED_QUEUE(K, V, NAME, HASH, EQ)      \
+    typedef struct                                                \
+    {                                                             \
+        K key;                                                    \
+        V value;                                                  \
+    } coalescing_##NAME##_entry_t;                                \
+                                                                  \
+    DEFINE_LINKED_QUEUE(coalescing_##NAME##_entry_t, coalescing_##NAME) \
+                                                                  \
+    static inline K coalescing_##NAME##_key_of_(const linked_coalescing_##NAME##_queue_t *node) \
+    {                                                             \
+        return node->data.key;                                    \
+    }                                                             \
+                                                                  \
+    DEFINE_LINKED_QUEUE_INDEX(K, linked_coalescing_##NAME##_queue_t, coalescing_##NAME, coalescing_##NAME##_key_of_, HASH, EQ) \
+                                                                  \
+    typedef void (*coalescing_##NAME##_merge_fn)(V *pending, V incoming, void *ctx); \
+                                                                  \
+    typedef struct coalescing_##NAME##_queue_t                    \
+    {                                                             \
+        linked_coalescing_##NAME##_queue_t queue;                 \
+        coalescing_##NAME##_index_t index;                        \
+        coalescing_##NAME##_merge_fn merge;                       \
+        void *merge_ctx;                                          \
+        size_t coalesced;                                         \
+    } coalescing_##NAME##_queue_t;                                \
+                                                                  \
+    /* A NULL merge callback makes later appends replace the pending value */ \
+    static inline void coalescing_##NAME##_queue_init(coalescing_##NAME##_queue_t *q, coalescing_##NAME##_merge_fn merge, void *ctx) \
+    {                                                             \
+        linked_coalescing_##NAME##_queue_init(&q->queue);         \
+        coalescing_##NAME##_index_init(&q->index);                \
+        q->merge = merge;                                         \
+        q->merge_ctx = ctx;                                       \
+        q->coalesced = 0;                                         \
+    }                                                             \
+                                                                  \
+    static inline bool coalescing_##NAME##_queue_append(coalescing_##NAME##_queue_t *q, K key, V value) \
+    {                                                             \
+        if (!q)                                                   \
+        {                                                         \
+            return FALSE;                                         \
+        }                                                         \
+                                                                  \
+        linked_coalescing_##NAME##_queue_t *pending = coalescing_##NAME##_index_find(&q->index, key); \
+        if (pending)                                              \
+        {                                                         \
+            if (q->merge)                                         \
+            {                                                     \
+                q->merge(&pending->data.value, value, q->merge_ctx); \
+            }                                                     \
+            else                                                  \
+            {                                                     \
+                pending->data.value = value;                      \
+            }                                                     \
+                                                                  \
+            q->coalesced++;                                       \
+            return TRUE;                                          \
+        }                                                         \
+                                                                  \
+        if (!coalescing_##NAME##_index_reserve(&q->index, q->index.count + 1)) \
+        {                                                         \
+            return FALSE;                                         \
+        }                                                         \
+                                                                  \
+        coalescing_##NAME##_entry_t entry;                        \
+        entry.key = key;                                          \
+        entry.value = value;                                      \
+        if (!linked_coalescing_##NAME##_queue_append(&q->queue, entry)) \
+        {                                                         \
+            return FALSE;                                         \
+        }                                                         \
+                                                                  \
+        return coalescing_##NAME##_index_insert(&q->index, q->queue.tail); \
+    }                                                             \
+                                                                  \
+    static inline bool coalescing_##NAME##_queue_contains(const coalescing_##NAME##_queue_t *q, K key) \
+    {                                                             \
+        return coalescing_##NAME##_index_find(&q->index, key) != NULL; \
+    }                                                             \
+                                                                  \
+    static inline bool coalescing_##NAME##_queue_pop(coalescing_##NAME##_queue_t *q, K *key, V *value) \
+    {                                                             \
+        if (!q || !q->queue.next)                                 \
+        {                                                         \
+            return FALSE;                                         \
+        }                                                         \
+                                                                  \
+        coalescing_##NAME##_entry_t entry;                        \
+        coalescing_##NAME##_index_remove(&q->index, q->queue.next->data.key); \
+        linked_coalescing_##NAME##_queue_pop(&q->queue, &entry);  \
+        if (key)                                                  \
+        {                                                         \
+            *key = entry.key;                                     \
+        }                                                         \
+                                                                  \
+        if (value)                                                \
+        {                                                         \
+            *value = entry.value;                                 \
+        }                                                         \
+                                                                  \
+        return TRUE;                                              \
+    }                                                             \
+                                                                  \
+    static inline void coalescing_##NAME##_queue_free(coalescing_##NAME##_queue_t *q) \
+    {                                                             \
+        if (!q)                                                   \
+        {                                                         \
+            return;                                               \
+        }                                                         \
+                                                                  \
+        linked_coalescing_##NAME##_queue_free(q->queue.next);     \
+        linked_coalescing_##NAME##_queue_init(&q->queue);         \
+        coalescing_##NAME##_index_free(&q->index);                \
+    }
+
+// ============= UNIQUE LINKED QUEUE =============
+// A linked queue that holds each value at most once, for "enqueue if not
+// already queued" workloads such as graph crawls. A node hash index gives
+// O(1) `_contains` and `_append_unique`; `_pop` drops the value from the
+// index, so it may be queued again afterwards.
+//
+// Usage:
+//   - DEFINE_UNIQUE_LINKED_QUEUE(ValueType, name, hash, eq) requires a prior
+//     DEFINE_LINKED_QUEUE(ValueType, name).
+#define DEFINE_UNIQUE_LINKED_QUEUE(V, NAME, HASH, EQ)             \
+    static inline V unique_##NAME##_key_of_(const linked_##NAME##_queue_t *node) \
+    {                                                             \
+        return node->data;                                        \
+    }                                                             \
+                                                                  \
+    DEFINE_LINKED_QUEUE_INDEX(V, linked_##NAME##_queue_t, unique_##NAME, unique_##NAME##_key_of_, HASH, EQ) \
+                                                                  \
+    typedef struct unique_##NAME##_queue_t                        \
+    {                                                             \
+        linked_##NAME##_queue_t queue;                            \
+        unique_##NAME##_index_t index;                            \
+    } unique_##NAME##_queue_t;                                    \
+                                                                  \
+    static inline void unique_##NAME##_queue_init(unique_##NAME##_queue_t *q) \
+    {                                                             \
+        linked_##NAME##_queue_init(&q->queue);                    \
+        unique_##NAME##_index_init(&q->index);                    \
+    }                                                             \
+                                                                  \
+    static inline bool unique_##NAME##_queue_contains(const unique_##NAME##_queue_t *q, V data) \
+    {                                                             \
+        return unique_##NAME##_index_find(&q->index, data) != NULL; \
+    }                                                             \
+                                                                  \
+    /* Returns FALSE if the value was already queued or allocation failed */ \
+    static inline bool unique_##NAME##_queue_append_unique(unique_##NAME##_queue_t *q, V data) \
+    {                                                             \
+        if (!q || unique_##NAME##_index_find(&q->index, data))    \
+        {                                                         \
+            return FALSE;                                         \
+        }                                                         \
+                                                                  \
+        if (!unique_##NAME##_index_reserve(&q->index, q->index.count + 1)) \
+        {                                                         \
+            return FALSE;                                         \
+        }                                                         \
+                                                                  \
+        if (!linked_##NAME##_queue_append(&q->queue, data))       \
+        {                                                         \
+            return FALSE;                                         \
+        }                                                         \
+                                                                  \
+        return unique_##NAME##_index_insert(&q->index, q->queue.tail); \
+    }                                                             \
+                                                                  \
+    static inline bool unique_##NAME##_queue_pop(unique_##NAME##_queue_t *q, V *out) \
+    {                                                             \
+        if (!q || !q->queue.next)                                 \
+        {                                                         \
+            return FALSE;                                         \
+        }                                                         \
+                                                                  \
+        unique_##NAME##_index_remove(&q->index, q->queue.next->data); \
+        return linked_##NAME##_queue_pop(&q->queue, out);         \
+    }                                                             \
+                                                                  \
+    static inline void unique_##NAME##_queue_free(unique_##NAME##_queue_t *q) \
+    {                                                             \
+        if (!q)                                                   \
+        {                                                         \
+            return;                                               \
+        }                                                         \
+                                                                  \
+        linked_##NAME##_queue_free(q->queue.next);                \
+        linked_##NAME##_queue_init(&q->queue);                    \
+        unique_##NAME##_index_free(&q->index);                    \
+    }
+
+// ============= DOUBLY LINKED DEQUE =============
+// A typed doubly linked deque with O(1) insertion and removal at both ends
+// and O(1) removal of an arbitrary node through the handle returned by the
+// push functions. Moving a node to either end is also O(1), which makes the
+// deque usable as an LRU list or as a cancellable work queue.
+//
+// Usage:
+//   - DEFINE_LINKED_DEQUE(ValueType, name) declares linked_name_deque_t.
+//   - Node handles stay valid until the node is removed or the deque freed.
+#define DEFINE_LINKED_DEQUE(V, NAME)                              \
+    typedef struct linked_##NAME##_deque_node_t                   \
+    {                                                             \
+        V data;                                                   \
+        struct linked_##NAME##_deque_node_t *prev;                \
+        struct linked_##NAME##_deque_node_t *next;                \
+    } linked_##NAME##_deque_node_t;                               \
+                                                                  \
+    typedef struct linked_##NAME##_deque_t                        \
+    {                                                             \
+        linked_##NAME##_deque_node_t *head;                       \
+        linked_##NAME##_deque_node_t *tail;                       \
+        size_t size;                                              \
+    } linked_##NAME##_deque_t;                                    \
+                                                                  \
+    static inline void linked_##NAME##_deque_init(linked_##NAME##_deque_t *deque) \
+    {                                                             \
+        deque->head = NULL;                                       \
+        deque->tail = NULL;                                       \
+        deque->size = 0;                                          \
+    }                                                             \
+                                                                  \
+    /* Links a detached node at the front of the deque */         \
+    static inline void linked_##NAME##_deque_link_front(linked_##NAME##_deque_t *deque, linked_##NAME##_deque_node_t *node) \
+    {                                                             \
+        node->prev = NULL;                                        \
+        node->next = deque->head;                                 \
+        if (deque->head)                                          \
+        {                                                         \
+            deque->head->prev = node;                             \
+        }                                                         \
+        else                                                      \
+        {                                                         \
+            deque->tail = node;                                   \
+        }                                                         \
+                                                                  \
+        deque->head = node;                                       \
+        deque->size++;                                            \
+    }                                                             \
+                                                                  \
+    /* Links a detached node at the back of the deque */          \
+    static inline void linked_##NAME##_deque_link_back(linked_##NAME##_deque_t *deque, linked_##NAME##_deque_node_t *node) \
+    {                                                             \
+        node->next = NULL;                                        \
+        node->prev = deque->tail;                                 \
+        if (deque->tail)                                          \
+        {                                                         \
+            deque->tail->next = node;                             \
+        }                                                         \
+        else                                                      \
+        {                                                         \
+            deque->head = node;                                   \
+        }                                                         \
+                                                                  \
+        deque->tail = node;                                       \
+        deque->size++;                                            \
+    }                                                             \
+                                                                  \
+    /* Detaches a node from the deque without freeing it */       \
+    static inline void linked_##NAME##_deque_unlink(linked_##NAME##_deque_t *deque, linked_##NAME##_deque_node_t *node) \
+    {                                                             \
+        if (node->prev)                                           \
+        {                                                         \
+            node->prev->next = node->next;                        \
+        }                                                         \
+        else                                                      \
+        {                                                         \
+            deque->head = node->next;                             \
+        }                                                         \
+                                                                  \
+        if (node->next)                                           \
+        {                                                         \
+            node->next->prev = node->prev;                        \
+        }                                                         \
+        else                                                      \
+        {                                                         \
+            deque->tail = node->prev;                             \
+        }                                                         \
+                                                                  \
+        node->prev = NULL;                                        \
+        node->next = NULL;                                        \
+        deque->size--;                                            \
+    }                                                             \
+                                                                  \
+    static inline linked_##NAME##_deque_node_t *linked_##NAME##_deque_push_front(linked_##NAME##_deque_t *deque, V data) \
+    {                                                             \
+        if (!deque)                                               \
+        {                                                         \
+            return NULL;                                          \
+        }                                                         \
+                                                                  \
+        linked_##NAME##_deque_node_t *node = malloc(sizeof(linked_##NAME##_deque_node_t)); \
+        if (!node)                                                \
+        {                                                         \
+            return NULL;                                          \
+        }                                                         \
+                                                                  \
+        node->data = data;                                        \
+        linked_##NAME##_deque_link_front(deque, node);            \
+        return node;                                              \
+    }                                                             \
+                                                                  \
+    static inline linked_##NAME##_deque_node_t *linked_##NAME##_deque_push_back(linked_##NAME##_deque_t *deque, V data) \
+    {                                                             \
+        if (!deque)                                               \
+        {                                                         \
+            return NULL;                                          \
+        }                                                         \
+                                                                  \
+        linked_##NAME##_deque_node_t *node = malloc(sizeof(linked_##NAME##_deque_node_t)); \
+        if (!node)                                                \
+        {                                                         \
+            return NULL;                                          \
+        }                                                         \
+                                                                  \
+        node->data = data;                                        \
+        linked_##NAME##_deque_link_back(deque, node);             \
+        return node;                                              \
+    }                                                             \
+                                                                  \
+    /* Unlinks and frees a node, optionally copying its value out */ \
+    static inline void linked_##NAME##_deque_remove(linked_##NAME##_deque_t *deque, linked_##NAME##_deque_node_t *node, V *out) \
+    {                                                             \
+        if (!deque || !node)                                      \
+        {                                                         \
+            return;                                               \
+        }                                                         \
+                                                                  \
+        if (out)                                                  \
+        {                                                         \
+            *out = node->data;                                    \
+        }                                                         \
+                                                                  \
+        linked_##NAME##_deque_unlink(deque, node);                \
+        free(node);                                               \
+    }                                                             \
+                                                                  \
+    static inline bool linked_##NAME##_deque_pop_front(linked_##NAME##_deque_t *deque, V *out) \
+    {                                                             \
+        if (!deque || !deque->head)                               \
+        {                                                         \
+            return FALSE;                                         \
+        }                                                         \
+                                                                  \
+        linked_##NAME##_deque_remove(deque, deque->head, out);    \
+        return TRUE;                                              \
+    }                                                             \
+                                                                  \
+    static inline bool linked_##NAME##_deque_pop_back(linked_##NAME##_deque_t *deque, V *out) \
+    {                                                             \
+        if (!deque || !deque->tail)                               \
+        {                                                         \
+            return FALSE;                                         \
+        }                                                         \
+                                                                  \
+        linked_##NAME##_deque_remove(deque, deque->tail, out);    \
+        return TRUE;                                              \
+    }                                                             \
+                                                                  \
+    static inline void linked_##NAME##_deque_move_to_front(linked_##NAME##_deque_t *deque, linked_##NAME##_deque_node_t *node) \
+    {                                                             \
+        if (deque->head == node)                                  \
+        {                                                         \
+            return;                                               \
+        }                                                         \
+                                                                  \
+        linked_##NAME##_deque_unlink(deque, node);                \
+        linked_##NAME##_deque_link_front(deque, node);            \
+    }                                                             \
+                                                                  \
+    static inline void linked_##NAME##_deque_move_to_back(linked_##NAME##_deque_t *deque, linked_##NAME##_deque_node_t *node) \
+    {                                                             \
+        if (deque->tail == node)                                  \
+        {                                                         \
+            return;                                               \
+        }                                                         \
+                                                                  \
+        linked_##NAME##_deque_unlink(deque, node);                \
+        linked_##NAME##_deque_link_back(deque, node);             \
+    }                                                             \
+                                                                  \
+    static inline void linked_##NAME##_deque_free(linked_##NAME##_deque_t *deque) \
+    {                                                             \
+        if (!deque)                                               \
+        {                                                         \
+            return;                                               \
+        }                                                         \
+                                                                  \
+        linked_##NAME##_deque_node_t *current = deque->head;      \
+        while (current)                                           \
+        {                                                         \
+            linked_##NAME##_deque_node_t *next_node = current->next; \
+            free(current);                                        \
+            current = next_node;                                  \
+        }                                                         \
+                                                                  \
+        linked_##NAME##_deque_init(deque);                        \
+    }
+
+// ============= XOR LINKED DEQUE =============
+// A typed deque storing a single link word per node: the XOR of the
+// addresses of its neighbours. Both ends support O(1) push and pop, and an
+// iterator walks the deque in either direction by carrying the previously
+// visited node. Nodes cannot be unlinked through a bare handle; use
+// DEFINE_LINKED_DEQUE when arbitrary removal is required.
+//
+// Usage:
+//   - DEFINE_XOR_LINKED_DEQUE(ValueType, name) declares xor_name_deque_t.
+#define DEFINE_XOR_LINKED_DEQUE(V, NAME)                          \
+    typedef struct xor_##NAME##_deque_node_t                      \
+    {                                                             \
+        V data;                                                   \
+        uintptr_t link;                                           \
+    } xor_##NAME##_deque_node_t;                                  \
+                                                                  \
+    typedef struct xor_##NAME##_deque_t                           \
+    {                                                             \
+        xor_##NAME##_deque_node_t *head;                          \
+        xor_##NAME##_deque_node_t *tail;                          \
+        size_t size;                                              \
+    } xor_##NAME##_deque_t;                                       \
+                                                                  \
+    typedef struct xor_##NAME##_deque_iter_t                      \
+    {                                                             \
+        xor_##NAME##_deque_node_t *prev;                          \
+        xor_##NAME##_deque_node_t *current;                       \
+    } xor_##NAME##_deque_iter_t;                                  \
+                                                                  \
+    static inline xor_##NAME##_deque_node_t *xor_##NAME##_deque_step_(const xor_##NAME##_deque_node_t *node, const xor_##NAME##_deque_node_t *from) \
+    {                                                             \
+        return (xor_##NAME##_deque_node_t *)(node->link ^ (uintptr_t)from); \
+    }                                                             \
+                                                                  \
+    static inline void xor_##NAME##_deque_init(xor_##NAME##_deque_t *deque) \
+    {                                                             \
+        deque->head = NULL;                                       \
+        deque->tail = NULL;                                       \
+        deque->size = 0;                                          \
+    }                                                             \
+                                                                  \
+    /* Pushes before `*end`, where `*end` is the head or the tail pointer */ \
+    static inline bool xor_##NAME##_deque_push_(xor_##NAME##_deque_t *deque, xor_##NAME##_deque_node_t **end, xor_##NAME##_deque_node_t **other, V data) \
+    {                                                             \
+        xor_##NAME##_deque_node_t *node = malloc(sizeof(xor_##NAME##_deque_node_t)); \
+        if (!node)                                                \
+        {                                                         \
+            return FALSE;                                         \
+        }                                                         \
+                                                                  \
+        node->data = data;                                        \
+        node->link = (uintptr_t)*end;                             \
+        if (*end)                                                 \
+        {                                                         \
+            (*end)->link ^= (uintptr_t)node;                      \
+        }                                                         \
+        else                                                      \
+        {                                                         \
+            *other = node;                                        \
+        }                                                         \
+                                                                  \
+        *end = node;                                              \
+        deque->size++;                                            \
+        return TRUE;                                              \
+    }                                                             \
+                                                                  \
+    /* Pops from `*end`, where `*end` is the head or the tail pointer */ \
+    static inline bool xor_##NAME##_deque_pop_(xor_##NAME##_deque_t *deque, xor_##NAME##_deque_node_t **end, xor_##NAME##_deque_node_t **other, V *out) \
+    {                                                             \
+        xor_##NAME##_deque_node_t *node = *end;                   \
+        if (!node)                                                \
+        {                                                         \
+            return FALSE;                                         \
+        }                                                         \
+                                                                  \
+        if (out)                                                  \
+        {                                                         \
+            *out = node->data;                                    \
+        }                                                         \
+                                                                  \
+        xor_##NAME##_deque_node_t *neighbour = xor_##NAME##_deque_step_(node, NULL); \
+        if (neighbour)                                            \
+        {                                                         \
+            neighbour->link ^= (uintptr_t)node;                   \
+        }                                                         \
+        else                                                      \
+        {                                                         \
+            *other = NULL;                                        \
+        }                                                         \
+                                                                  \
+        *end = neighbour;                                         \
+        deque->size--;                                            \
+        free(node);                                               \
+        return TRUE;                                              \
+    }                                                             \
+                                                                  \
+    static inline bool xor_##NAME##_deque_push_front(xor_##NAME##_deque_t *deque, V data) \
+    {                                                             \
+        return deque && xor_##NAME##_deque_push_(deque, &deque->head, &deque->tail, data); \
+    }                                                             \
+                                                                  \
+    static inline bool xor_##NAME##_deque_push_back(xor_##NAME##_deque_t *deque, V data) \
+    {                                                             \
+        return deque && xor_##NAME##_deque_push_(deque, &deque->tail, &deque->head, data); \
+    }                                                             \
+                                                                  \
+    static inline bool xor_##NAME##_deque_pop_front(xor_##NAME##_deque_t *deque, V *out) \
+    {                                                             \
+        return deque && xor_##NAME##_deque_pop_(deque, &deque->head, &deque->tail, out); \
+    }                                                             \
+                                                                  \
+    static inline bool xor_##NAME##_deque_pop_back(xor_##NAME##_deque_t *deque, V *out) \
+    {                                                             \
+        return deque && xor_##NAME##_deque_pop_(deque, &deque->tail, &deque->head, out); \
+    }                                                             \
+                                                                  \
+    /* Starts a front-to-back walk */                             \
+    static inline xor_##NAME##_deque_iter_t xor_##NAME##_deque_begin(const xor_##NAME##_deque_t *deque) \
+    {                                                             \
+        xor_##NAME##_deque_iter_t it = { NULL, deque->head };     \
+        return it;                                                \
+    }                                                             \
+                                                                  \
+    /* Starts a back-to-front walk */                             \
+    static inline xor_##NAME##_deque_iter_t xor_##NAME##_deque_rbegin(const xor_##NAME##_deque_t *deque) \
+    {                                                             \
+        xor_##NAME##_deque_iter_t it = { NULL, deque->tail };     \
+        return it;                                                \
+    }                                                             \
+                                                                  \
+    /* Returns the current value and advances, or NULL once exhausted */ \
+    static inline V *xor_##NAME##_deque_iter_next(xor_##NAME##_deque_iter_t *it) \
+    {                                                             \
+        xor_##NAME##_deque_node_t *node = it->current;            \
+        if (!node)                                                \
+        {                                                         \
+            return NULL;                                          \
+        }                                                         \
+                                                                  \
+        it->current = xor_##NAME##_deque_step_(node, it->prev);   \
+        it->prev = node;                                          \
+        return &node->data;                                       \
+    }                                                             \
+                                                                  \
+    static inline void xor_##NAME##_deque_free(xor_##NAME##_deque_t *deque) \
+    {                                                             \
+        if (!deque)                                               \
+        {                                                         \
+            return;                                               \
+        }                                                         \
+                                                                  \
+        xor_##NAME##_deque_iter_t it = xor_##NAME##_deque_begin(deque); \
+        while (it.current)                                        \
+        {                                                         \
+            xor_##NAME##_deque_node_t *node = it.current;         \
+            it.current = xor_##NAME##_deque_step_(node, it.prev); \
+            it.prev = node;                                       \
+            free(node);                                           \
+        }                                                         \
+                                                                  \
+        xor_##NAME##_deque_init(deque);                           \
+    }
+
+// ============= RATE-LIMITED LINKED QUEUE =============
+// Throttles consumption of a bounded queue with a token bucket: tokens are
+// refilled continuously at `rate` per second up to `burst`, and each popped
+// element consumes one token. Batch pops reserve the tokens available up
+// front, take the batch with one bounded `_pop_batch` and refund what went
+// unused, and the blocking pop sleeps exactly until the next token is due
+// instead of polling. The limiter lock is never held while the bounded queue
+// is touched, so watermark callbacks may use the limiter.
+//
+// Usage:
+//   - DEFINE_RATE_LIMITED_LINKED_QUEUE(ValueType, name) requires a prior
+//     DEFINE_BOUNDED_LINKED_QUEUE(ValueType, name).
+//   - Producers append directly to the `queue` member.
+#define DEFINE_RATE_LIMITED_LINKED_QUEUE(V, NAME)                 \
+    typedef struct rate_limited_##NAME##_queue_t                  \
+    {                                                             \
+        bounded_##NAME##_queue_t *queue;                          \
+        pthread_mutex_t lock;                                     \
+        double rate;                                              \
+        double burst;                                             \
+        double tokens;                                            \
+        uint64_t last_refill;                                     \
+    } rate_limited_##NAME##_queue_t;                              \
+                                                                  \
+    /* `rate` is in elements per second; the bucket starts full */ \
+    static inline bool rate_limited_##NAME##_queue_init(rate_limited_##NAME##_queue_t *q, bounded_##NAME##_queue_t *queue, double rate, double burst) \
+    {                                                             \
+        if (!q || !queue || rate <= 0 || burst < 1)               \
+        {                                                         \
+            return FALSE;                                         \
+        }                                                         \
+                                                                  \
+        if (pthread_mutex_init(&q->lock, NULL) != 0)              \
+        {                                                         \
+            return FALSE;                                         \
+        }                                                         \
+                                                                  \
+        q->queue = queue;                                         \
+        q->rate = rate;                                           \
+        q->burst = burst;                                         \
+        q->tokens = burst;                                        \
+        q->last_refill = linked_queue_now_ns();                   \
+        return TRUE;                                              \
+    }                                                             \
+                                                                  \
+    /* Refills the bucket; the caller must hold the lock */       \
+    static inline void rate_limited_##NAME##_queue_refill_(rate_limited_##NAME##_queue_t *q) \
+    {                                                             \
+        const uint64_t now = linked_queue_now_ns();               \
+        q->tokens += (double)(now - q->last_refill) * q->rate / 1e9; \
+        if (q->tokens > q->burst)                                 \
+        {                                                         \
+            q->tokens = q->burst;                                 \
+        }                                                         \
+                                                                  \
+        q->last_refill = now;                                     \
+    }                                                             \
+                                                                  \
+    /* Takes up to `max` elements, limited by the tokens available right now */ \
+    static inline size_t rate_limited_##NAME##_queue_pop_batch(rate_limited_##NAME##_queue_t *q, V *out, size_t max) \
+    {                                                             \
+        if (!q || !out || !max)                                   \
+        {                                                         \
+            return 0;                                             \
+        }                                                         \
+                                                                  \
+        pthread_mutex_lock(&q->lock);                             \
+        rate_limited_##NAME##_queue_refill_(q);                   \
+        const size_t allowed = q->tokens < 1 ? 0 : q->tokens < (double)max ? (size_t)q->tokens : max; \
+        q->tokens -= (double)allowed;                             \
+        pthread_mutex_unlock(&q->lock);                           \
+                                                                  \
+        if (!allowed)                                             \
+        {                                                         \
+            return 0;                                             \
+        }                                                         \
+                                                                  \
+        const size_t taken = bounded_##NAME##_queue_pop_batch(q->queue, out, allowed, 0); \
+        if (taken < allowed)                                      \
+        {                                                         \
+            pthread_mutex_lock(&q->lock);                         \
+            const double refunded = q->tokens + (double)(allowed - taken); \
+            q->tokens = refunded < q->burst ? refunded : q->burst; \
+            pthread_mutex_unlock(&q->lock);                       \
+        }                                                         \
+                                                                  \
+        return taken;                                             \
+    }                                                             \
+                                                                  \
+    static inline bool rate_limited_##NAME##_queue_pop(rate_limited_##NAME##_queue_t *q, V *out) \
+    {                                                             \
+        return rate_limited_##NAME##_queue_pop_batch(q, out, 1) == 1; \
+    }                                                             \
+                                                                  \
+    /* Sleeps until a token is available, then blocks until an element arrives; FALSE once closed */ \
+    static inline bool rate_limited_##NAME##_queue_pop_wait(rate_limited_##NAME##_queue_t *q, V *out) \
+    {                                                             \
+        if (!q)                                                   \
+        {                                                         \
+            return FALSE;                                         \
+        }                                                         \
+                                                                  \
+        pthread_mutex_lock(&q->lock);                             \
+        for (;;)                                                  \
+        {                                                         \
+            rate_limited_##NAME##_queue_refill_(q);               \
+            if (q->tokens >= 1)                                   \
+            {                                                     \
+                break;                                            \
+            }                                                     \
+                                                                  \
+            const uint64_t wait = (uint64_t)((1 - q->tokens) * 1e9 / q->rate) + 1; \
+            const struct timespec ts = { (time_t)(wait / 1000000000ull), (long)(wait % 1000000000ull) }; \
+            pthread_mutex_unlock(&q->lock);                       \
+            nanosleep(&ts, NULL);                                 \
+            pthread_mutex_lock(&q->lock);                         \
+        }                                                         \
+                                                                  \
+        /* Reserve the token before blocking so concurrent callers cannot overdraw */ \
+        q->tokens -= 1;                                           \
+        pthread_mutex_unlock(&q->lock);                           \
+                                                                  \
+        if (bounded_##NAME##_queue_pop_wait(q->queue, out))       \
+        {                                                         \
+            return TRUE;                                          \
+        }                                                         \
+                                                                  \
+        pthread_mutex_lock(&q->lock);                             \
+        q->tokens = q->tokens + 1 < q->burst ? q->tokens + 1 : q->burst; \
+        pthread_mutex_unlock(&q->lock);                           \
+        return FALSE;                                             \
+    }                                                             \
+                                                                  \
+    static inline void rate_limited_##NAME##_queue_free(rate_limited_##NAME##_queue_t *q) \
+    {                                                             \
+        if (q)                                                    \
+        {                                                         \
+            pthread_mutex_destroy(&q->lock);                      \
+        }                                                         \
+    }
+
+// ============= FLAT-COMBINING LINKED QUEUE =============
+// A concurrent FIFO for heavily contended bursts. Instead of every thread
+// fighting over the queue, each thread publishes its append or pop request
+// in its own cache-line-sized slot; whichever thread grabs the combiner flag
+// applies every pending request to the plain linked queue in one sweep,
+// while the others spin on their own slot until their request is served.
+//
+// Usage:
+//   - DEFINE_FLAT_COMBINING_LINKED_QUEUE(ValueType, name) requires a prior
+//     DEFINE_LINKED_QUEUE(ValueType, name).
+//   - Each thread claims a slot with `_attach` and passes it to every call;
+//     the number of slots bounds the number of concurrently attached threads.
+enum
+{
+    LINKED_QUEUE_FC_NONE = 0,
+    LINKED_QUEUE_FC_APPEND,
+    LINKED_QUEUE_FC_POP
+};
+
+#define DEFINE_FLAT_COMBINING_LINKED_QUEUE(V, NAME)               \
+    typedef struct                                                \
+    {                                                             \
+        _Alignas(LINKED_QUEUE_CACHE_LINE) atomic_int op;          \
+        atomic_bool in_use;                                       \
+        bool result;                                              \
+        V value;                                                  \
+    } fc_##NAME##_slot_t;                                         \
+                                                                  \
+    typedef struct fc_##NAME##_queue_t                            \
+    {                                                             \
+        linked_##NAME##_queue_t queue;                            \
+        _Alignas(LINKED_QUEUE_CACHE_LINE) atomic_bool combining;  \
+        fc_##NAME##_slot_t *slots;                                \
+        size_t slot_count;                                        \
+    } fc_##NAME##_queue_t;                                        \
+                                                                  \
+    static inline bool fc_##NAME##_queue_init(fc_##NAME##_queue_t *q, size_t slot_count) \
+    {                                                             \
+        if (!q || !slot_count)                                    \
+        {                                                         \
+            return FALSE;                                         \
+        }                                                         \
+                                                                  \
+        q->slots = aligned_alloc(LINKED_QUEUE_CACHE_LINE, slot_count * sizeof(fc_##NAME##_slot_t)); \
+        if (!q->slots)                                            \
+        {                                                         \
+            return FALSE;                                         \
+        }                                                         \
+                                                                  \
+        for (size_t i = 0; i < slot_count; i++)                   \
+        {                                                         \
+            atomic_init(&q->slots[i].op, LINKED_QUEUE_FC_NONE);   \
+            atomic_init(&q->slots[i].in_use, FALSE);              \
+        }                                                         \
+                                                                  \
+        linked_##NAME##_queue_init(&q->queue);                    \
+        atomic_init(&q->combining, FALSE);                        \
+        q->slot_count = slot_count;                               \
+        return TRUE;                                              \
+    }                                                             \
+                                                                  \
+    /* Claims a publication slot for the calling thread, or NULL if all are taken */ \
+    static inline fc_##NAME##_slot_t *fc_##NAME##_queue_attach(fc_##NAME##_queue_t *q) \
+    {                                                             \
+        for (size_t i = 0; i < q->slot_count; i++)                \
+        {                                                         \
+            bool expected = FALSE;                                \
+            if (atomic_compare_exchange_strong(&q->slots[i].in_use, &expected, TRUE)) \
+            {                                                     \
+                return &q->slots[i];                              \
+            }                                                     \
+        }                                                         \
+                                                                  \
+        return NULL;                                              \
+    }                                                             \
+                                                                  \
+    static inline void fc_##NAME##_queue_detach(fc_##NAME##_slot_t *slot) \
+    {                                                             \
+        atomic_store_explicit(&slot->in_use, FALSE, memory_order_release); \
+    }                                                             \
+                                                                  \
+    /* Applies every published request; the caller must own the combiner flag */ \
+    static inline void fc_##NAME##_queue_combine_(fc_##NAME##_queue_t *q) \
+    {                                                             \
+        for (size_t i = 0; i < q->slot_count; i++)                \
+        {                                                         \
+            fc_##NAME##_slot_t *slot = &q->slots[i];              \
+            const int op = atomic_load_explicit(&slot->op, memory_order_acquire); \
+            if (op == LINKED_QUEUE_FC_APPEND)                     \
+            {                                                     \
+                slot->result = linked_##NAME##_queue_append(&q->queue, slot->value); \
+            }                                                     \
+            else if (op == LINKED_QUEUE_FC_POP)                   \
+            {                                                     \
+                slot->result = linked_##NAME##_queue_pop(&q->queue, &slot->value); \
+            }                                                     \
+            else                                                  \
+            {                                                     \
+                continue;                                         \
+            }                                                     \
+                                                                  \
+            atomic_store_explicit(&slot->op, LINKED_QUEUE_FC_NONE, memory_order_release); \
+        }                                                         \
+    }                                                             \
+                                                                  \
+    static inline bool fc_##NAME##_queue_execute_(fc_##NAME##_queue_t *q, fc_##NAME##_slot_t *slot, int op) \
+    {                                                             \
+        atomic_store_explicit(&slot->op, op, memory_order_release); \
+                                                                  \
+        for (unsigned spins = 0;; spins++)                        \
+        {                                                         \
+            if (atomic_load_explicit(&slot->op, memory_order_acquire) == LINKED_QUEUE_FC_NONE) \
+            {                                                     \
+                return slot->result;                              \
+            }                                                     \
+                                                                  \
+            if (!atomic_load_explicit(&q->combining, memory_order_relaxed) && !atomic_exchange_explicit(&q->combining, TRUE, memory_order_acquire)) \
+            {                                                     \
+                fc_##NAME##_queue_combine_(q);                    \
+                atomic_store_explicit(&q->combining, FALSE, memory_order_release); \
+                continue;                                         \
+            }                                                     \
+                                                                  \
+            if (spins >= LINKED_QUEUE_SPIN_LIMIT)                 \
+            {                                                     \
+                sched_yield();                                    \
+            }                                                     \
+        }                                                         \
+    }                                                             \
+                                                                  \
+    static inline bool fc_##NAME##_queue_append(fc_##NAME##_queue_t *q, fc_##NAME##_slot_t *slot, V data) \
+    {                                                             \
+        if (!q || !slot)                                          \
+        {                                                         \
+            return FALSE;                                         \
+        }                                                         \
+                                                                  \
+        slot->value = data;                                       \
+        return fc_##NAME##_queue_execute_(q, slot, LINKED_QUEUE_FC_APPEND); \
+    }                                                             \
+                                                                  \
+    static inline bool fc_##NAME##_queue_pop(fc_##NAME##_queue_t *q, fc_##NAME##_slot_t *slot, V *out) \
+    {                                                             \
+        if (!q || !slot)                                          \
+        {                                                         \
+            return FALSE;                                         \
+        }                                                         \
+                                                                  \
+        if (!fc_##NAME##_queue_execute_(q, slot, LINKED_QUEUE_FC_POP)) \
+        {                                                         \
+            return FALSE;                                         \
+        }                                                         \
+                                                                  \
+        if (out)                                                  \
+        {                                                         \
+            *out = slot->value;                                   \
+        }                                                         \
+                                                                  \
+        return TRUE;                                              \
+    }                                                             \
+                                                                  \
+    /* Releases the nodes and slots; no thread may be inside an operation */ \
+    static inline void fc_##NAME##_queue_free(fc_##NAME##_queue_t *q) \
+    {                                                             \
+        if (!q)                                                   \
+        {                                                         \
+            return;                                               \
+        }                                                         \
+                                                                  \
+        linked_##NAME##_queue_free(q->queue.next);                \
+        linked_##NAME##_queue_init(&q->queue);                    \
+        free(q->slots);                                           \
+        q->slots = NULL;                                          \
+        q->slot_count = 0;                                        \
+    }
+
+// ============= BROADCAST RING =============
+// A single-producer ring buffer where every subscribed consumer sees every
+// element (Disruptor-style fan-out). Each consumer owns a sequence cursor;
+// the producer only overwrites a slot once the slowest active consumer has
+// moved past it. Consumers read elements in place through `_peek`, so one
+// published element serves all consumers without copies or allocations.
+//
+// Usage:
+//   - DEFINE_BROADCAST_RING(ValueType, name) declares broadcast_name_ring_t.
+//   - The capacity must be a power of two.
+//   - A consumer sees every element published after `_subscribe` returns;
+//     subscribing while the producer runs is safe. Each cursor must be
+//     driven by a single thread, and ids freed by `_unsubscribe` are reused.
+#define DEFINE_BROADCAST_RING(V, NAME)                            \
+    typedef struct                                                \
+    {                                                             \
+        _Alignas(LINKED_QUEUE_CACHE_LINE) atomic_uint_fast64_t sequence; \
+        atomic_bool active;                                       \
+    } broadcast_##NAME##_cursor_t;                                \
+                                                                  \
+    typedef struct broadcast_##NAME##_ring_t                      \
+    {                                                             \
+        V *slots;                                                 \
+        size_t mask;                                              \
+        broadcast_##NAME##_cursor_t *cursors;                     \
+        size_t max_consumers;                                     \
+        atomic_size_t consumer_count;                             \
+        pthread_mutex_t subscribe_lock;                           \
+        _Alignas(LINKED_QUEUE_CACHE_LINE) atomic_uint_fast64_t published; \
+        uint64_t gate;                                            \
+    } broadcast_##NAME##_ring_t;                                  \
+                                                                  \
+    static inline bool broadcast_##NAME##_ring_init(broadcast_##NAME##_ring_t *ring, size_t capacity, size_t max_consumers) \
+    {                                                             \
+        if (!ring || !capacity || (capacity & (capacity - 1)) || !max_consumers) \
+        {                                                         \
+            return FALSE;                                         \
+        }                                                         \
+                                                                  \
+        ring->slots = malloc(capacity * sizeof(V));               \
+        ring->cursors = aligned_alloc(LINKED_QUEUE_CACHE_LINE, max_consumers * sizeof(broadcast_##NAME##_cursor_t)); \
+        if (!ring->slots || !ring->cursors || pthread_mutex_init(&ring->subscribe_lock, NULL) != 0) \
+        {                                                         \
+            free(ring->slots);                                    \
+            free(ring->cursors);                                  \
+            return FALSE;                                         \
+        }                                                         \
+                                                                  \
+        for (size_t i = 0; i < max_consumers; i++)                \
+        {                                                         \
+            atomic_init(&ring->cursors[i].sequence, 0);           \
+            atomic_init(&ring->cursors[i].active, FALSE);         \
+        }                                                         \
+                                                                  \
+        ring->mask = capacity - 1;                                \
+        ring->max_consumers = max_consumers;                      \
+        atomic_init(&ring->consumer_count, 0);                    \
+        atomic_init(&ring->published, 0);                         \
+        ring->gate = 0;                                           \
+        return TRUE;                                              \
+    }                                                             \
+                                                                  \
+    /* Registers a consumer that sees every element published from now on; returns its id or -1 if all are taken */ \
+    static inline int broadcast_##NAME##_ring_subscribe(broadcast_##NAME##_ring_t *ring) \
+    {                                                             \
+        /* Serialized with the gate refresh, so a gate computed without this cursor never passes `published` as read here */ \
+        pthread_mutex_lock(&ring->subscribe_lock);                \
+        size_t id = 0;                                            \
+        while (id < ring->max_consumers && atomic_load_explicit(&ring->cursors[id].active, memory_order_acquire)) \
+        {                                                         \
+            id++;                                                 \
+        }                                                         \
+                                                                  \
+        if (id == ring->max_consumers)                            \
+        {                                                         \
+            pthread_mutex_unlock(&ring->subscribe_lock);          \
+            return -1;                                            \
+        }                                                         \
+                                                                  \
+        atomic_store_explicit(&ring->cursors[id].sequence, atomic_load_explicit(&ring->published, memory_order_acquire), memory_order_relaxed); \
+        atomic_store_explicit(&ring->cursors[id].active, TRUE, memory_order_release); \
+        if (id >= atomic_load_explicit(&ring->consumer_count, memory_order_relaxed)) \
+        {                                                         \
+            atomic_store_explicit(&ring->consumer_count, id + 1, memory_order_release); \
+        }                                                         \
+                                                                  \
+        pthread_mutex_unlock(&ring->subscribe_lock);              \
+        return (int)id;                                           \
+    }                                                             \
+                                                                  \
+    /* Stops the producer from waiting on this consumer and frees its id for reuse */ \
+    static inline void broadcast_##NAME##_ring_unsubscribe(broadcast_##NAME##_ring_t *ring, int id) \
+    {                                                             \
+        atomic_store_explicit(&ring->cursors[id].active, FALSE, memory_order_release); \
+    }                                                             \
+                                                                  \
+    /* Recomputes the slowest active cursor; producer side only, and only when the cached gate is exhausted */ \
+    static inline uint64_t broadcast_##NAME##_ring_min_cursor_(broadcast_##NAME##_ring_t *ring, uint64_t next) \
+    {                                                             \
+        uint64_t min = next;                                      \
+        pthread_mutex_lock(&ring->subscribe_lock);                \
+        const size_t count = atomic_load_explicit(&ring->consumer_count, memory_order_acquire); \
+        for (size_t i = 0; i < count && i < ring->max_consumers; i++) \
+        {                                                         \
+            if (!atomic_load_explicit(&ring->cursors[i].active, memory_order_acquire)) \
+            {                                                     \
+                continue;                                         \
+            }                                                     \
+                                                                  \
+            const uint64_t sequence = atomic_load_explicit(&ring->cursors[i].sequence, memory_order_acquire); \
+            min = sequence < min ? sequence : min;                \
+        }                                                         \
+                                                                  \
+        pthread_mutex_unlock(&ring->subscribe_lock);              \
+        return min;                                               \
+    }                                                             \
+                                                                  \
+    static inline bool broadcast_##NAME##_ring_try_publish(broadcast_##NAME##_ring_t *ring, V data) \
+    {                                                             \
+        const uint64_t next = atomic_load_explicit(&ring->published, memory_order_relaxed); \
+        if (next - ring->gate > ring->mask)                       \
+        {                                                         \
+            ring->gate = broadcast_##NAME##_ring_min_cursor_(ring, next); \
+            if (next - ring->gate > ring->mask)                   \
+            {                                                     \
+                return FALSE;                                     \
+            }                                                     \
+        }                                                         \
+                                                                  \
+        ring->slots[next & ring->mask] = data;                    \
+        atomic_store_explicit(&ring->published, next + 1, memory_order_release); \
+        return TRUE;                                              \
+    }                                                             \
+                                                                  \
+    /* Publishes an element, waiting for the slowest consumer if the ring is full */ \
+    static inline void broadcast_##NAME##_ring_publish(broadcast_##NAME##_ring_t *ring, V data) \
+    {                                                             \
+        for (unsigned spins = 0; !broadcast_##NAME##_ring_try_publish(ring, data); spins++) \
+        {                                                         \
+            if (spins >= LINKED_QUEUE_SPIN_LIMIT)                 \
+            {                                                     \
+                sched_yield();                                    \
+            }                                                     \
+        }                                                         \
+    }                                                             \
+                                                                  \
+    /* Returns the consumer's next element in place, or NULL if none is published yet */ \
+    static inline const V *broadcast_##NAME##_ring_peek(broadcast_##NAME##_ring_t *ring, int id) \
+    {                                                             \
+        const uint64_t sequence = atomic_load_explicit(&ring->cursors[id].sequence, memory_order_relaxed); \
+        if (sequence >= atomic_load_explicit(&ring->published, memory_order_acquire)) \
+        {                                                         \
+            return NULL;                                          \
+        }                                                         \
+                                                                  \
+        return &ring->slots[sequence & ring->mask];               \
+    }                                                             \
+                                                                  \
+    /* Hands the slot returned by `_peek` back to the producer */ \
+    static inline void broadcast_##NAME##_ring_release(broadcast_##NAME##_ring_t *ring, int id) \
+    {                                                             \
+        const uint64_t sequence = atomic_load_explicit(&ring->cursors[id].sequence, memory_order_relaxed); \
+        atomic_store_explicit(&ring->cursors[id].sequence, sequence + 1, memory_order_release); \
+    }                                                             \
+                                                                  \
+    static inline bool broadcast_##NAME##_ring_consume(broadcast_##NAME##_ring_t *ring, int id, V *out) \
+    {                                                             \
+        const V *data = broadcast_##NAME##_ring_peek(ring, id);   \
+        if (!data)                                                \
+        {                                                         \
+            return FALSE;                                         \
+        }                                                         \
+                                                                  \
+        if (out)                                                  \
+        {                                                         \
+            *out = *data;                                         \
+        }                                                         \
+                                                                  \
+        broadcast_##NAME##_ring_release(ring, id);                \
+        return TRUE;                                              \
+    }                                                             \
+                                                                  \
+    static inline void broadcast_##NAME##_ring_free(broadcast_##NAME##_ring_t *ring) \
+    {                                                             \
+        if (!ring)                                                \
+        {                                                         \
+            return;                                               \
+        }                                                         \
+                                                                  \
+        free(ring->slots);                                        \
+        free(ring->cursors);                                      \
+        pthread_mutex_destroy(&ring->subscribe_lock);             \
+        ring->slots = NULL;                                       \
+        ring->cursors = NULL;                                     \
+    }
+
+// ============= STATIC QUEUE =============
+// A fixed-capacity FIFO whose storage lives inline in the queue struct, so
+// it can be embedded in per-connection state or placed on the stack without
+// touching the heap. The capacity is a compile-time power of two; indices
+// wrap with a mask instead of a modulo. The API mirrors the linked queue,
+// except that `_append`/`_prepend` return FALSE once the queue is full.
+//
+// Usage:
+//   - DEFINE_STATIC_QUEUE(ValueType, name, 64) declares static_name_queue_t.
+//   - A capacity that is not a power of two fails to compile.
+#define DEFINE_STATIC_QUEUE(V, NAME, CAP)                         \
+    _Static_assert((CAP) > 0 && ((CAP) & ((CAP) - 1)) == 0, "static queue capacity must be a power of two"); \
+                                                                  \
+    typedef struct static_##NAME##_queue_t                        \
+    {                                                             \
+        V data[CAP];                                              \
+        size_t head;                                              \
+        size_t size;                                              \
+    } static_##NAME##_queue_t;                                    \
+                                                                  \
+    static inline void static_##NAME##_queue_init(static_##NAME##_queue_t *q) \
+    {                                                             \
+        q->head = 0;                                              \
+        q->size = 0;                                              \
+    }                                                             \
+                                                                  \
+    static inline bool static_##NAME##_queue_append(static_##NAME##_queue_t *q, V data) \
+    {                                                             \
+        if (!q || q->size == (CAP))                               \
+        {                                                         \
+            return FALSE;                                         \
+        }                                                         \
+                                                                  \
+        q->data[(q->head + q->size) & ((CAP) - 1)] = data;        \
+        q->size++;                                                \
+        return TRUE;                                              \
+    }                                                             \
+                                                                  \
+    static inline bool static_##NAME##_queue_prepend(static_##NAME##_queue_t *q, V data) \
+    {                                                             \
+        if (!q || q->size == (CAP))                               \
+        {                                                         \
+            return FALSE;                                         \
+        }                                                         \
+                                                                  \
+        q->head = (q->head - 1) & ((CAP) - 1);                    \
+        q->data[q->head] = data;                                  \
+        q->size++;                                                \
+        return TRUE;                                              \
+    }                                                             \
+                                                                  \
+    static inline bool static_##NAME##_queue_pop(static_##NAME##_queue_t *q, V *out) \
+    {                                                             \
+        if (!q || q->size == 0)                                   \
+        {                                                         \
+            return FALSE;                                         \
+        }                                                         \
+                                                                  \
+        if (out)                                                  \
+        {                                                         \
+            *out = q->data[q->head];                              \
+        }                                                         \
+                                                                  \
+        q->head = (q->head + 1) & ((CAP) - 1);                    \
+        q->size--;                                                \
+        return TRUE;                                              \
+    }                                                             \
+                                                                  \
+    /* Returns the first element in place, or NULL if the queue is empty */ \
+    static inline V const *static_##NAME##_queue_peek(const static_##NAME##_queue_t *q) \
+    {                                                             \
+        if (!q || q->size == 0)                                   \
+        {                                                         \
+            return NULL;                                          \
+        }                                                         \
+                                                                  \
+        return &q->data[q->head];                                 \
+    }                                                             \
+                                                                  \
+    /* Nothing to release; empties the queue so it can be reused */ \
+    static inline void static_##NAME##_queue_free(static_##NAME##_queue_t *q) \
+    {                                                             \
+        if (!q)                                                   \
+        {                                                         \
+            return;                                               \
+        }                                                         \
+                                                                  \
+        static_##NAME##_queue_init(q);                            \
+    }
+
 #ifndef LINKED_QUEUE_GENERIC_DEFINED
     DEFINE_LINKED_QUEUE(void *, generic);
+    DEFINE_BOUNDED_LINKED_QUEUE(void *, generic);
 #   define LINKED_QUEUE_GENERIC_DEFINED 1
 #endif
 
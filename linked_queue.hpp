@@ -0,0 +1,613 @@
+/*
+ * This code is distributed under the terms of the GNU General Public License.
+ * For more information, please refer to the LICENSE file in the root directory.
+ * -------------------------------------------------
+ * Copyright (C) 2025 Rodrigo R.
+ * This program comes with ABSOLUTELY NO WARRANTY; for details type show w'.
+ * This is free software, and you are welcome to redistribute it
+ * under certain conditions; type show c' for details.
+*/
+
+#ifndef FLUENT_LIBC_LINKED_QUEUE_HPP
+#define FLUENT_LIBC_LINKED_QUEUE_HPP
+
+// ============= FLUENT LIB C++ =============
+// Typed Linked Queue for C++
+// ----------------------------------------
+// `fluent::linked_queue<T, Alloc>` keeps the node layout of the C
+// `DEFINE_LINKED_QUEUE` macro (singly linked nodes, a tail pointer and a
+// cached size) but owns its elements the C++ way:
+//   - Elements are constructed in place with `emplace_back`/`emplace_front`
+//   - Move-only types are supported; nothing is copied unless asked for
+//   - Nodes are allocated through `Alloc`, rebound to the node type, and
+//     allocator-aware elements are built with uses-allocator construction
+//   - `fluent::pmr::linked_queue<T>` takes a `std::pmr::memory_resource *`
+//   - The destructor destroys every element and releases every node
+//   - Forward iterators make the queue usable with <algorithm> and ranges
+//   - `fluent::static_queue<T, N>` is a heap-free, constexpr ring buffer
+//     with a power-of-two capacity fixed at compile time
+//
+// Example:
+// ----------------------------------------
+//   fluent::linked_queue<std::unique_ptr<job>> queue;
+//   queue.emplace_back(std::make_unique<job>(42));
+//
+//   while (!queue.empty()) {
+//       run(*queue.front());
+//       queue.pop_front();
+//   }
+//
+// Requires C++17.
+//
+
+// ============= INCLUDES =============
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#if __has_include(<memory_resource>)
+#   include <memory_resource>
+#   define FLUENT_LINKED_QUEUE_HAS_PMR 1
+#endif
+
+namespace fluent
+{
+    template <typename T, typename Alloc = std::allocator<T>>
+    class linked_queue
+    {
+        // The value is constructed separately so allocator-aware elements receive the queue's allocator
+        struct node
+        {
+            node *next;
+            union
+            {
+                T value;
+            };
+
+            node() noexcept : next(nullptr)
+            {
+            }
+
+            ~node()
+            {
+            }
+        };
+
+        using node_allocator = typename std::allocator_traits<Alloc>::template rebind_alloc<node>;
+        using node_traits = std::allocator_traits<node_allocator>;
+        using value_allocator = typename std::allocator_traits<Alloc>::template rebind_alloc<T>;
+        using value_traits = std::allocator_traits<value_allocator>;
+
+        template <bool Const>
+        class basic_iterator
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = std::conditional_t<Const, const T *, T *>;
+            using reference = std::conditional_t<Const, const T &, T &>;
+
+            basic_iterator() noexcept = default;
+
+            // Allows iterator -> const_iterator
+            template <bool OtherConst, typename = std::enable_if_t<Const && !OtherConst>>
+            basic_iterator(const basic_iterator<OtherConst> &other) noexcept : node_(other.node_)
+            {
+            }
+
+            reference operator*() const noexcept
+            {
+                return node_->value;
+            }
+
+            pointer operator->() const noexcept
+            {
+                return std::addressof(node_->value);
+            }
+
+            basic_iterator &operator++() noexcept
+            {
+                node_ = node_->next;
+                return *this;
+            }
+
+            basic_iterator operator++(int) noexcept
+            {
+                basic_iterator previous = *this;
+                node_ = node_->next;
+                return previous;
+            }
+
+            friend bool operator==(const basic_iterator &a, const basic_iterator &b) noexcept
+            {
+                return a.node_ == b.node_;
+            }
+
+            friend bool operator!=(const basic_iterator &a, const basic_iterator &b) noexcept
+            {
+                return a.node_ != b.node_;
+            }
+
+        private:
+            friend class linked_queue;
+
+            explicit basic_iterator(node *current) noexcept : node_(current)
+            {
+            }
+
+            node *node_ = nullptr;
+        };
+
+    public:
+        using value_type = T;
+        using allocator_type = Alloc;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = T &;
+        using const_reference = const T &;
+        using iterator = basic_iterator<false>;
+        using const_iterator = basic_iterator<true>;
+
+        linked_queue() noexcept(std::is_nothrow_default_constructible_v<node_allocator>) = default;
+
+        explicit linked_queue(const Alloc &alloc) noexcept : alloc_(alloc)
+        {
+        }
+
+        linked_queue(const linked_queue &other)
+            : alloc_(node_traits::select_on_container_copy_construction(other.alloc_))
+        {
+            try
+            {
+                append_copies(other);
+            }
+            catch (...)
+            {
+                clear();
+                throw;
+            }
+        }
+
+        linked_queue(linked_queue &&other) noexcept
+            : alloc_(std::move(other.alloc_)), head_(other.head_), tail_(other.tail_), size_(other.size_)
+        {
+            other.release();
+        }
+
+        linked_queue &operator=(const linked_queue &other)
+        {
+            if (this == &other)
+            {
+                return *this;
+            }
+
+            clear();
+            if constexpr (node_traits::propagate_on_container_copy_assignment::value)
+            {
+                alloc_ = other.alloc_;
+            }
+
+            append_copies(other);
+            return *this;
+        }
+
+        linked_queue &operator=(linked_queue &&other) noexcept(node_traits::propagate_on_container_move_assignment::value || node_traits::is_always_equal::value)
+        {
+            if (this == &other)
+            {
+                return *this;
+            }
+
+            clear();
+            if constexpr (node_traits::propagate_on_container_move_assignment::value)
+            {
+                alloc_ = std::move(other.alloc_);
+            }
+            else if (alloc_ != other.alloc_)
+            {
+                // Nodes from a foreign allocator cannot be adopted; move the elements instead
+                for (node *current = other.head_; current; current = current->next)
+                {
+                    emplace_back(std::move(current->value));
+                }
+
+                other.clear();
+                return *this;
+            }
+
+            head_ = other.head_;
+            tail_ = other.tail_;
+            size_ = other.size_;
+            other.release();
+            return *this;
+        }
+
+        ~linked_queue()
+        {
+            clear();
+        }
+
+        template <typename... Args>
+        reference emplace_back(Args &&...args)
+        {
+            node *created = make_node(std::forward<Args>(args)...);
+            if (tail_)
+            {
+                tail_->next = created;
+            }
+            else
+            {
+                head_ = created;
+            }
+
+            tail_ = created;
+            size_++;
+            return created->value;
+        }
+
+        template <typename... Args>
+        reference emplace_front(Args &&...args)
+        {
+            node *created = make_node(std::forward<Args>(args)...);
+            created->next = head_;
+            head_ = created;
+            if (!tail_)
+            {
+                tail_ = created;
+            }
+
+            size_++;
+            return created->value;
+        }
+
+        void push_back(const T &value)
+        {
+            emplace_back(value);
+        }
+
+        void push_back(T &&value)
+        {
+            emplace_back(std::move(value));
+        }
+
+        void push_front(const T &value)
+        {
+            emplace_front(value);
+        }
+
+        void push_front(T &&value)
+        {
+            emplace_front(std::move(value));
+        }
+
+        /* Destroys the first element; the queue must not be empty */
+        void pop_front()
+        {
+            node *first = head_;
+            head_ = first->next;
+            if (!head_)
+            {
+                tail_ = nullptr;
+            }
+
+            size_--;
+            destroy_node(first);
+        }
+
+        /* Moves the first element into `out` and removes it; returns false if empty */
+        bool try_pop(T &out)
+        {
+            if (!head_)
+            {
+                return false;
+            }
+
+            out = std::move(head_->value);
+            pop_front();
+            return true;
+        }
+
+        reference front()
+        {
+            return head_->value;
+        }
+
+        const_reference front() const
+        {
+            return head_->value;
+        }
+
+        reference back()
+        {
+            return tail_->value;
+        }
+
+        const_reference back() const
+        {
+            return tail_->value;
+        }
+
+        iterator begin() noexcept
+        {
+            return iterator(head_);
+        }
+
+        iterator end() noexcept
+        {
+            return iterator(nullptr);
+        }
+
+        const_iterator begin() const noexcept
+        {
+            return const_iterator(head_);
+        }
+
+        const_iterator end() const noexcept
+        {
+            return const_iterator(nullptr);
+        }
+
+        const_iterator cbegin() const noexcept
+        {
+            return begin();
+        }
+
+        const_iterator cend() const noexcept
+        {
+            return end();
+        }
+
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return size_ == 0;
+        }
+
+        [[nodiscard]] size_type size() const noexcept
+        {
+            return size_;
+        }
+
+        void clear() noexcept
+        {
+            node *current = head_;
+            while (current)
+            {
+                node *next = current->next;
+                destroy_node(current);
+                current = next;
+            }
+
+            release();
+        }
+
+        void swap(linked_queue &other) noexcept
+        {
+            using std::swap;
+            if constexpr (node_traits::propagate_on_container_swap::value)
+            {
+                swap(alloc_, other.alloc_);
+            }
+
+            swap(head_, other.head_);
+            swap(tail_, other.tail_);
+            swap(size_, other.size_);
+        }
+
+        allocator_type get_allocator() const noexcept
+        {
+            return allocator_type(alloc_);
+        }
+
+    private:
+        template <typename... Args>
+        node *make_node(Args &&...args)
+        {
+            node *created = node_traits::allocate(alloc_, 1);
+            ::new (static_cast<void *>(created)) node();
+            try
+            {
+                value_allocator value_alloc(alloc_);
+                value_traits::construct(value_alloc, std::addressof(created->value), std::forward<Args>(args)...);
+            }
+            catch (...)
+            {
+                created->~node();
+                node_traits::deallocate(alloc_, created, 1);
+                throw;
+            }
+
+            return created;
+        }
+
+        void destroy_node(node *target) noexcept
+        {
+            value_allocator value_alloc(alloc_);
+            value_traits::destroy(value_alloc, std::addressof(target->value));
+            target->~node();
+            node_traits::deallocate(alloc_, target, 1);
+        }
+
+        void append_copies(const linked_queue &other)
+        {
+            for (node *current = other.head_; current; current = current->next)
+            {
+                emplace_back(current->value);
+            }
+        }
+
+        void release() noexcept
+        {
+            head_ = nullptr;
+            tail_ = nullptr;
+            size_ = 0;
+        }
+
+        node_allocator alloc_{};
+        node *head_ = nullptr;
+        node *tail_ = nullptr;
+        size_type size_ = 0;
+    };
+
+    template <typename T, typename Alloc>
+    void swap(linked_queue<T, Alloc> &a, linked_queue<T, Alloc> &b) noexcept
+    {
+        a.swap(b);
+    }
+
+#ifdef FLUENT_LINKED_QUEUE_HAS_PMR
+    namespace pmr
+    {
+        // Nodes come from the given memory resource, e.g. a monotonic arena or pool:
+        //   std::pmr::unsynchronized_pool_resource pool;
+        //   fluent::pmr::linked_queue<request> queue(&pool);
+        template <typename T>
+        using linked_queue = fluent::linked_queue<T, std::pmr::polymorphic_allocator<T>>;
+    }
+#endif
+
+    // Fixed-capacity FIFO with inline storage, the C++ side of `DEFINE_STATIC_QUEUE`.
+    // Every operation is constexpr, so a literal `T` can be queued during constant
+    // evaluation. Slots are default-constructed up front and assigned on push.
+    template <typename T, std::size_t N>
+    class static_queue
+    {
+        static_assert(N > 0 && (N & (N - 1)) == 0, "static_queue capacity must be a power of two");
+
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+        using reference = T &;
+        using const_reference = const T &;
+
+        constexpr static_queue() = default;
+
+        /* Returns false if the queue is full */
+        template <typename... Args>
+        constexpr bool emplace_back(Args &&...args)
+        {
+            if (size_ == N)
+            {
+                return false;
+            }
+
+            data_[(head_ + size_) & (N - 1)] = T(std::forward<Args>(args)...);
+            size_++;
+            return true;
+        }
+
+        /* Returns false if the queue is full */
+        template <typename... Args>
+        constexpr bool emplace_front(Args &&...args)
+        {
+            if (size_ == N)
+            {
+                return false;
+            }
+
+            head_ = (head_ - 1) & (N - 1);
+            data_[head_] = T(std::forward<Args>(args)...);
+            size_++;
+            return true;
+        }
+
+        constexpr bool push_back(const T &value)
+        {
+            return emplace_back(value);
+        }
+
+        constexpr bool push_back(T &&value)
+        {
+            return emplace_back(std::move(value));
+        }
+
+        constexpr bool push_front(const T &value)
+        {
+            return emplace_front(value);
+        }
+
+        constexpr bool push_front(T &&value)
+        {
+            return emplace_front(std::move(value));
+        }
+
+        /* Drops the first element; the queue must not be empty */
+        constexpr void pop_front()
+        {
+            data_[head_] = T();
+            head_ = (head_ + 1) & (N - 1);
+            size_--;
+        }
+
+        /* Moves the first element into `out` and removes it; returns false if empty */
+        constexpr bool try_pop(T &out)
+        {
+            if (size_ == 0)
+            {
+                return false;
+            }
+
+            out = std::move(data_[head_]);
+            pop_front();
+            return true;
+        }
+
+        constexpr reference front()
+        {
+            return data_[head_];
+        }
+
+        constexpr const_reference front() const
+        {
+            return data_[head_];
+        }
+
+        constexpr reference back()
+        {
+            return data_[(head_ + size_ - 1) & (N - 1)];
+        }
+
+        constexpr const_reference back() const
+        {
+            return data_[(head_ + size_ - 1) & (N - 1)];
+        }
+
+        [[nodiscard]] constexpr bool empty() const noexcept
+        {
+            return size_ == 0;
+        }
+
+        [[nodiscard]] constexpr bool full() const noexcept
+        {
+            return size_ == N;
+        }
+
+        [[nodiscard]] constexpr size_type size() const noexcept
+        {
+            return size_;
+        }
+
+        [[nodiscard]] static constexpr size_type capacity() noexcept
+        {
+            return N;
+        }
+
+        constexpr void clear()
+        {
+            while (size_ != 0)
+            {
+                pop_front();
+            }
+
+            head_ = 0;
+        }
+
+    private:
+        T data_[N]{};
+        size_type head_ = 0;
+        size_type size_ = 0;
+    };
+}
+
+#endif //FLUENT_LIBC_LINKED_QUEUE_HPP
@@ -0,0 +1,222 @@
+/*
+ * This code is distributed under the terms of the GNU General Public License.
+ * For more information, please refer to the LICENSE file in the root directory.
+ * -------------------------------------------------
+ * Copyright (C) 2025 Rodrigo R.
+ * This program comes with ABSOLUTELY NO WARRANTY; for details type show w'.
+ * This is free software, and you are welcome to redistribute it
+ * under certain conditions; type show c' for details.
+*/
+
+#ifndef FLUENT_LIBC_LINKED_QUEUE_ASYNC_HPP
+#define FLUENT_LIBC_LINKED_QUEUE_ASYNC_HPP
+
+// ============= FLUENT LIB C++ =============
+// Coroutine Async Queue
+// ----------------------------------------
+// `fluent::async_queue<T>` is a thread-safe FIFO whose `pop()` is awaited
+// instead of blocking a thread:
+//   - `co_await queue.pop()` completes immediately if an element is queued,
+//     otherwise the coroutine is suspended and parked in a waiter list
+//   - `push`/`emplace` hands the element directly to the oldest waiter and
+//     resumes exactly that one, so a resumed coroutine always has a value
+//   - A waiter resumes inline on the producer's thread unless `pop` was
+//     given a scheduler, which then decides where the coroutine continues
+//   - The queue must outlive every coroutine suspended in `pop()`; it is
+//     an error (asserted in debug builds) to destroy it with waiters parked
+//
+// Example:
+// ----------------------------------------
+//   fluent::async_queue<request> queue;
+//
+//   task serve() {
+//       for (;;) {
+//           request next = co_await queue.pop(post_to_loop, &loop);
+//           handle(std::move(next));
+//       }
+//   }
+//
+// Requires C++20.
+//
+
+// ============= INCLUDES =============
+#include "linked_queue.hpp"
+#include <cassert>
+#include <coroutine>
+#include <mutex>
+#include <optional>
+
+namespace fluent
+{
+    template <typename T, typename Alloc = std::allocator<T>>
+    class async_queue
+    {
+    public:
+        using value_type = T;
+
+        // Called with the suspended coroutine once it has a value; must eventually resume it
+        using scheduler_fn = void (*)(std::coroutine_handle<> handle, void *ctx);
+
+        class pop_awaiter
+        {
+        public:
+            pop_awaiter(async_queue &queue, scheduler_fn schedule, void *ctx) noexcept
+                : queue_(queue), schedule_(schedule), ctx_(ctx)
+            {
+            }
+
+            pop_awaiter(const pop_awaiter &) = delete;
+            pop_awaiter &operator=(const pop_awaiter &) = delete;
+
+            bool await_ready()
+            {
+                std::lock_guard<std::mutex> guard(queue_.lock_);
+                return queue_.take_locked(value_);
+            }
+
+            bool await_suspend(std::coroutine_handle<> handle)
+            {
+                std::lock_guard<std::mutex> guard(queue_.lock_);
+                if (queue_.take_locked(value_))
+                {
+                    return false;
+                }
+
+                handle_ = handle;
+                queue_.park_locked(this);
+                return true;
+            }
+
+            T await_resume()
+            {
+                return std::move(*value_);
+            }
+
+        private:
+            friend class async_queue;
+
+            void resume()
+            {
+                if (schedule_)
+                {
+                    schedule_(handle_, ctx_);
+                }
+                else
+                {
+                    handle_.resume();
+                }
+            }
+
+            async_queue &queue_;
+            scheduler_fn schedule_;
+            void *ctx_;
+            std::optional<T> value_;
+            std::coroutine_handle<> handle_;
+            pop_awaiter *next_ = nullptr;
+        };
+
+        async_queue() = default;
+
+        explicit async_queue(const Alloc &alloc) : items_(alloc)
+        {
+        }
+
+        /* The queue must outlive every coroutine parked in `pop()`; parked waiters are never resumed */
+        ~async_queue()
+        {
+            assert(!waiters_head_ && "async_queue destroyed with suspended waiters");
+        }
+
+        async_queue(const async_queue &) = delete;
+        async_queue &operator=(const async_queue &) = delete;
+
+        /* Awaitable yielding the next element; `schedule` picks where the coroutine resumes */
+        [[nodiscard]] pop_awaiter pop(scheduler_fn schedule = nullptr, void *ctx = nullptr) noexcept
+        {
+            return pop_awaiter(*this, schedule, ctx);
+        }
+
+        template <typename... Args>
+        void emplace(Args &&...args)
+        {
+            pop_awaiter *waiter;
+            {
+                std::lock_guard<std::mutex> guard(lock_);
+                waiter = waiters_head_;
+                if (!waiter)
+                {
+                    items_.emplace_back(std::forward<Args>(args)...);
+                    return;
+                }
+
+                // Construct before unlinking, so a throwing constructor leaves the waiter parked
+                waiter->value_.emplace(std::forward<Args>(args)...);
+                waiters_head_ = waiter->next_;
+                if (!waiters_head_)
+                {
+                    waiters_tail_ = nullptr;
+                }
+            }
+
+            // Resume outside the lock; the coroutine may push or pop again right away
+            waiter->resume();
+        }
+
+        void push(const T &value)
+        {
+            emplace(value);
+        }
+
+        void push(T &&value)
+        {
+            emplace(std::move(value));
+        }
+
+        /* Non-suspending pop; returns false if nothing is queued */
+        bool try_pop(T &out)
+        {
+            std::lock_guard<std::mutex> guard(lock_);
+            return items_.try_pop(out);
+        }
+
+        [[nodiscard]] std::size_t size() const
+        {
+            std::lock_guard<std::mutex> guard(lock_);
+            return items_.size();
+        }
+
+    private:
+        bool take_locked(std::optional<T> &out)
+        {
+            if (items_.empty())
+            {
+                return false;
+            }
+
+            out.emplace(std::move(items_.front()));
+            items_.pop_front();
+            return true;
+        }
+
+        void park_locked(pop_awaiter *waiter) noexcept
+        {
+            if (waiters_tail_)
+            {
+                waiters_tail_->next_ = waiter;
+            }
+            else
+            {
+                waiters_head_ = waiter;
+            }
+
+            waiters_tail_ = waiter;
+        }
+
+        mutable std::mutex lock_;
+        linked_queue<T, Alloc> items_;
+        pop_awaiter *waiters_head_ = nullptr;
+        pop_awaiter *waiters_tail_ = nullptr;
+    };
+}
+
+#endif //FLUENT_LIBC_LINKED_QUEUE_ASYNC_HPP
@@ -0,0 +1,223 @@
+/*
+ * This code is distributed under the terms of the GNU General Public License.
+ * For more information, please refer to the LICENSE file in the root directory.
+ * -------------------------------------------------
+ * Copyright (C) 2025 Rodrigo R.
+ * This program comes with ABSOLUTELY NO WARRANTY; for details type show w'.
+ * This is free software, and you are welcome to redistribute it
+ * under certain conditions; type show c' for details.
+*/
+
+#include "linked_queue_executor.h"
+#include <sched.h>
+
+// Worker running on the current thread, if any
+static _Thread_local linked_queue_worker_t *current_worker = NULL;
+
+static bool take_local(linked_queue_worker_t *worker, linked_queue_task_t *task)
+{
+    pthread_mutex_lock(&worker->lock);
+    const bool taken = linked_task_deque_pop_back(&worker->tasks, task);
+    pthread_mutex_unlock(&worker->lock);
+    return taken;
+}
+
+static bool steal(linked_queue_executor_t *executor, const linked_queue_worker_t *thief, linked_queue_task_t *task)
+{
+    for (size_t i = 1; i < executor->worker_count; i++)
+    {
+        linked_queue_worker_t *victim = &executor->workers[(thief->index + i) % executor->worker_count];
+        pthread_mutex_lock(&victim->lock);
+        const bool taken = linked_task_deque_pop_front(&victim->tasks, task);
+        pthread_mutex_unlock(&victim->lock);
+
+        if (taken)
+        {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+static void *worker_main(void *arg)
+{
+    linked_queue_worker_t *worker = arg;
+    linked_queue_executor_t *executor = worker->executor;
+    current_worker = worker;
+
+    for (;;)
+    {
+        linked_queue_task_t task;
+        if (take_local(worker, &task) || steal(executor, worker, &task))
+        {
+            atomic_fetch_sub(&executor->pending, 1);
+            task.fn(task.arg);
+            continue;
+        }
+
+        // Registering as a sleeper before re-checking `pending` pairs with the check in submit
+        pthread_mutex_lock(&executor->idle_lock);
+        atomic_fetch_add(&executor->sleepers, 1);
+        while (!atomic_load(&executor->pending) && !atomic_load(&executor->stopping))
+        {
+            pthread_cond_wait(&executor->idle_cond, &executor->idle_lock);
+        }
+
+        atomic_fetch_sub(&executor->sleepers, 1);
+        pthread_mutex_unlock(&executor->idle_lock);
+
+        // Read `stopping` first: a submit that raises `pending` afterwards sees it and backs out
+        const bool stopping = atomic_load(&executor->stopping);
+        if (stopping && !atomic_load(&executor->pending))
+        {
+            break;
+        }
+
+        // A task was announced but is not linked yet, or another worker won the race
+        sched_yield();
+    }
+
+    current_worker = NULL;
+    return NULL;
+}
+
+bool linked_queue_executor_init(linked_queue_executor_t *executor, const size_t worker_count)
+{
+    if (!executor || !worker_count)
+    {
+        return FALSE;
+    }
+
+    executor->workers = malloc(worker_count * sizeof(linked_queue_worker_t));
+    if (!executor->workers)
+    {
+        return FALSE;
+    }
+
+    executor->worker_count = worker_count;
+    atomic_init(&executor->pending, 0);
+    atomic_init(&executor->sleepers, 0);
+    atomic_init(&executor->next_worker, 0);
+    atomic_init(&executor->stopping, FALSE);
+    pthread_mutex_init(&executor->idle_lock, NULL);
+    pthread_cond_init(&executor->idle_cond, NULL);
+
+    for (size_t i = 0; i < worker_count; i++)
+    {
+        linked_queue_worker_t *worker = &executor->workers[i];
+        pthread_mutex_init(&worker->lock, NULL);
+        linked_task_deque_init(&worker->tasks);
+        worker->executor = executor;
+        worker->index = i;
+    }
+
+    for (size_t i = 0; i < worker_count; i++)
+    {
+        if (pthread_create(&executor->workers[i].thread, NULL, worker_main, &executor->workers[i]) == 0)
+        {
+            continue;
+        }
+
+        // Stop the workers that did start; no task can have been submitted yet
+        atomic_store(&executor->stopping, TRUE);
+        pthread_mutex_lock(&executor->idle_lock);
+        pthread_cond_broadcast(&executor->idle_cond);
+        pthread_mutex_unlock(&executor->idle_lock);
+
+        for (size_t j = 0; j < i; j++)
+        {
+            pthread_join(executor->workers[j].thread, NULL);
+        }
+
+        for (size_t j = 0; j < worker_count; j++)
+        {
+            pthread_mutex_destroy(&executor->workers[j].lock);
+        }
+
+        pthread_cond_destroy(&executor->idle_cond);
+        pthread_mutex_destroy(&executor->idle_lock);
+        free(executor->workers);
+        executor->workers = NULL;
+        executor->worker_count = 0;
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+bool linked_queue_executor_submit(linked_queue_executor_t *executor, const linked_queue_task_fn fn, void *arg)
+{
+    if (!executor || !fn)
+    {
+        return FALSE;
+    }
+
+    linked_queue_worker_t *worker = current_worker;
+    const bool local = worker && worker->executor == executor;
+
+    // Announce before linking so `pending` never underflows, and before checking
+    // `stopping` so a worker cannot exit while this task is still on its way
+    atomic_fetch_add(&executor->pending, 1);
+    if (!local && atomic_load(&executor->stopping))
+    {
+        atomic_fetch_sub(&executor->pending, 1);
+        return FALSE;
+    }
+
+    if (!local)
+    {
+        worker = &executor->workers[atomic_fetch_add_explicit(&executor->next_worker, 1, memory_order_relaxed) % executor->worker_count];
+    }
+
+    const linked_queue_task_t task = { fn, arg };
+    pthread_mutex_lock(&worker->lock);
+    const bool queued = linked_task_deque_push_back(&worker->tasks, task) != NULL;
+    pthread_mutex_unlock(&worker->lock);
+
+    if (!queued)
+    {
+        atomic_fetch_sub(&executor->pending, 1);
+        return FALSE;
+    }
+
+    // Only wake someone if a worker is parked; busy workers find the task on their own
+    if (atomic_load(&executor->sleepers))
+    {
+        pthread_mutex_lock(&executor->idle_lock);
+        pthread_cond_signal(&executor->idle_cond);
+        pthread_mutex_unlock(&executor->idle_lock);
+    }
+
+    return TRUE;
+}
+
+void linked_queue_executor_shutdown(linked_queue_executor_t *executor)
+{
+    if (!executor || !executor->workers)
+    {
+        return;
+    }
+
+    atomic_store(&executor->stopping, TRUE);
+    pthread_mutex_lock(&executor->idle_lock);
+    pthread_cond_broadcast(&executor->idle_cond);
+    pthread_mutex_unlock(&executor->idle_lock);
+
+    for (size_t i = 0; i < executor->worker_count; i++)
+    {
+        pthread_join(executor->workers[i].thread, NULL);
+    }
+
+    for (size_t i = 0; i < executor->worker_count; i++)
+    {
+        linked_task_deque_free(&executor->workers[i].tasks);
+        pthread_mutex_destroy(&executor->workers[i].lock);
+    }
+
+    pthread_cond_destroy(&executor->idle_cond);
+    pthread_mutex_destroy(&executor->idle_lock);
+    free(executor->workers);
+    executor->workers = NULL;
+    executor->worker_count = 0;
+}
@@ -0,0 +1,85 @@
+/*
+ * This code is distributed under the terms of the GNU General Public License.
+ * For more information, please refer to the LICENSE file in the root directory.
+ * -------------------------------------------------
+ * Copyright (C) 2025 Rodrigo R.
+ * This program comes with ABSOLUTELY NO WARRANTY; for details type show w'.
+ * This is free software, and you are welcome to redistribute it
+ * under certain conditions; type show c' for details.
+*/
+
+#ifndef FLUENT_LIBC_LINKED_QUEUE_EXECUTOR_H
+#define FLUENT_LIBC_LINKED_QUEUE_EXECUTOR_H
+
+// ============= FLUENT LIB C =============
+// Work-Stealing Executor
+// ----------------------------------------
+// A fixed-size thread pool built on the linked deque. Each worker owns a
+// local deque of tasks:
+//   - Tasks submitted from a worker go to that worker's own deque
+//   - Tasks submitted from outside are spread round-robin across workers
+//   - A worker runs its newest local task first and, when idle, steals the
+//     oldest task from another worker
+//
+// Submitting and taking tasks only touch the per-worker deque locks; the
+// shared idle lock is taken just to wake or park a worker with nothing to do.
+//
+// Shutdown is graceful: every task submitted before (or by a task running
+// during) `linked_queue_executor_shutdown` runs before the workers exit.
+//
+// Example:
+// ----------------------------------------
+//   linked_queue_executor_t executor;
+//   linked_queue_executor_init(&executor, 4);
+//
+//   linked_queue_executor_submit(&executor, handle_request, request);
+//
+//   linked_queue_executor_shutdown(&executor);
+//
+
+// ============= INCLUDES =============
+#include "linked_queue.h"
+
+typedef void (*linked_queue_task_fn)(void *arg);
+
+typedef struct
+{
+    linked_queue_task_fn fn;
+    void *arg;
+} linked_queue_task_t;
+
+DEFINE_LINKED_DEQUE(linked_queue_task_t, task);
+
+struct linked_queue_executor_t;
+
+typedef struct linked_queue_worker_t
+{
+    pthread_mutex_t lock;
+    linked_task_deque_t tasks;
+    pthread_t thread;
+    struct linked_queue_executor_t *executor;
+    size_t index;
+} linked_queue_worker_t;
+
+typedef struct linked_queue_executor_t
+{
+    linked_queue_worker_t *workers;
+    size_t worker_count;
+    pthread_mutex_t idle_lock;
+    pthread_cond_t idle_cond;
+    atomic_size_t pending;
+    atomic_size_t sleepers;
+    atomic_size_t next_worker;
+    atomic_bool stopping;
+} linked_queue_executor_t;
+
+/* Starts `worker_count` threads; returns FALSE if any resource cannot be created */
+bool linked_queue_executor_init(linked_queue_executor_t *executor, size_t worker_count);
+
+/* Queues `fn(arg)`; returns FALSE after shutdown began or on allocation failure */
+bool linked_queue_executor_submit(linked_queue_executor_t *executor, linked_queue_task_fn fn, void *arg);
+
+/* Runs every queued task, joins the workers and releases all resources */
+void linked_queue_executor_shutdown(linked_queue_executor_t *executor);
+
+#endif //FLUENT_LIBC_LINKED_QUEUE_EXECUTOR_H
@@ -0,0 +1,253 @@
+/*
+ * This code is distributed under the terms of the GNU General Public License.
+ * For more information, please refer to the LICENSE file in the root directory.
+ * -------------------------------------------------
+ * Copyright (C) 2025 Rodrigo R.
+ * This program comes with ABSOLUTELY NO WARRANTY; for details type show w'.
+ * This is free software, and you are welcome to redistribute it
+ * under certain conditions; type show c' for details.
+*/
+
+#include "linked_queue_pipeline.h"
+
+static void *stage_main(void *arg)
+{
+    linked_queue_stage_t *stage = arg;
+    linked_queue_pipeline_t *pipeline = stage->pipeline;
+    linked_queue_stage_t *next = stage->index + 1 < pipeline->stage_count ? &pipeline->stages[stage->index + 1] : NULL;
+
+    void **items = malloc(pipeline->batch * sizeof(void *));
+    const size_t batch = items ? pipeline->batch : 1;
+    void *single;
+    if (!items)
+    {
+        items = &single;
+    }
+
+    size_t taken;
+    while ((taken = bounded_generic_queue_pop_many(&stage->input, items, batch)) > 0)
+    {
+        const uint64_t start = linked_queue_now_ns();
+        size_t produced = 0;
+
+        // Outputs are compacted in place and handed downstream as one batch
+        for (size_t i = 0; i < taken; i++)
+        {
+            void *out = stage->fn(items[i], stage->ctx);
+            if (out)
+            {
+                items[produced++] = out;
+            }
+        }
+
+        size_t rejected = 0;
+        if (next)
+        {
+            const size_t appended = bounded_generic_queue_append_many(&next->input, items, produced);
+            rejected = produced - appended;
+
+            // Outputs the next stage refused are handed back so their payloads are not lost
+            for (size_t i = appended; i < produced && pipeline->on_reject; i++)
+            {
+                pipeline->on_reject(items[i], pipeline->reject_ctx);
+            }
+        }
+
+        atomic_fetch_add(&stage->busy_ns, linked_queue_now_ns() - start);
+        atomic_fetch_add(&stage->processed, taken);
+        atomic_fetch_add(&stage->dropped, taken - produced);
+        atomic_fetch_add(&stage->rejected, rejected);
+    }
+
+    if (items != &single)
+    {
+        free(items);
+    }
+
+    // The last worker to leave signals end-of-stream downstream
+    if (atomic_fetch_sub(&stage->active, 1) == 1 && next)
+    {
+        bounded_generic_queue_close(&next->input);
+    }
+
+    return NULL;
+}
+
+void linked_queue_pipeline_init(linked_queue_pipeline_t *pipeline, const size_t queue_capacity, const size_t batch)
+{
+    pipeline->stages = NULL;
+    pipeline->stage_count = 0;
+    pipeline->queue_capacity = queue_capacity;
+    pipeline->batch = batch ? batch : 1;
+    pipeline->on_reject = NULL;
+    pipeline->reject_ctx = NULL;
+    pipeline->started = FALSE;
+}
+
+void linked_queue_pipeline_set_reject(linked_queue_pipeline_t *pipeline, const linked_queue_reject_fn fn, void *ctx)
+{
+    if (!pipeline || pipeline->started)
+    {
+        return;
+    }
+
+    pipeline->on_reject = fn;
+    pipeline->reject_ctx = ctx;
+}
+
+bool linked_queue_pipeline_add_stage(linked_queue_pipeline_t *pipeline, const linked_queue_stage_fn fn, void *ctx, const size_t parallelism)
+{
+    if (!pipeline || !fn || pipeline->started)
+    {
+        return FALSE;
+    }
+
+    linked_queue_stage_t *stages = realloc(pipeline->stages, (pipeline->stage_count + 1) * sizeof(linked_queue_stage_t));
+    if (!stages)
+    {
+        return FALSE;
+    }
+
+    linked_queue_stage_t *stage = &stages[pipeline->stage_count];
+    stage->fn = fn;
+    stage->ctx = ctx;
+    stage->parallelism = parallelism ? parallelism : 1;
+    stage->threads = NULL;
+    stage->pipeline = pipeline;
+    stage->index = pipeline->stage_count;
+
+    pipeline->stages = stages;
+    pipeline->stage_count++;
+    return TRUE;
+}
+
+bool linked_queue_pipeline_start(linked_queue_pipeline_t *pipeline)
+{
+    if (!pipeline || pipeline->started || !pipeline->stage_count)
+    {
+        return FALSE;
+    }
+
+    // Queues are only initialized once the stage array stops moving
+    for (size_t s = 0; s < pipeline->stage_count; s++)
+    {
+        linked_queue_stage_t *stage = &pipeline->stages[s];
+        if (!bounded_generic_queue_init(&stage->input, pipeline->queue_capacity, LINKED_QUEUE_CAPACITY_ELEMENTS, LINKED_QUEUE_OVERFLOW_BLOCK))
+        {
+            while (s-- > 0)
+            {
+                bounded_generic_queue_free(&pipeline->stages[s].input);
+            }
+
+            return FALSE;
+        }
+
+        atomic_init(&stage->active, 0);
+        atomic_init(&stage->processed, 0);
+        atomic_init(&stage->dropped, 0);
+        atomic_init(&stage->rejected, 0);
+        atomic_init(&stage->busy_ns, 0);
+    }
+
+    pipeline->started = TRUE;
+    bool ok = TRUE;
+
+    for (size_t s = 0; s < pipeline->stage_count; s++)
+    {
+        linked_queue_stage_t *stage = &pipeline->stages[s];
+        stage->threads = ok ? malloc(stage->parallelism * sizeof(pthread_t)) : NULL;
+        if (!stage->threads)
+        {
+            ok = FALSE;
+            stage->parallelism = 0;
+            continue;
+        }
+
+        // Count workers up front so an early finisher cannot close downstream too soon
+        atomic_store(&stage->active, stage->parallelism);
+        for (size_t t = 0; t < stage->parallelism; t++)
+        {
+            if (pthread_create(&stage->threads[t], NULL, stage_main, stage) != 0)
+            {
+                const size_t missing = stage->parallelism - t;
+                stage->parallelism = t;
+                ok = ok && t > 0;
+                if (atomic_fetch_sub(&stage->active, missing) == missing && s + 1 < pipeline->stage_count)
+                {
+                    bounded_generic_queue_close(&pipeline->stages[s + 1].input);
+                }
+
+                break;
+            }
+        }
+    }
+
+    if (!ok)
+    {
+        // Some stage has no workers, so end-of-stream cannot propagate on its own
+        for (size_t s = 0; s < pipeline->stage_count; s++)
+        {
+            bounded_generic_queue_close(&pipeline->stages[s].input);
+        }
+
+        linked_queue_pipeline_finish(pipeline);
+    }
+
+    return ok;
+}
+
+bool linked_queue_pipeline_push(linked_queue_pipeline_t *pipeline, void *item)
+{
+    if (!pipeline || !pipeline->started)
+    {
+        return FALSE;
+    }
+
+    return bounded_generic_queue_append(&pipeline->stages[0].input, item);
+}
+
+bool linked_queue_pipeline_metrics(linked_queue_pipeline_t *pipeline, const size_t stage, linked_queue_stage_metrics_t *out)
+{
+    if (!pipeline || !pipeline->started || stage >= pipeline->stage_count || !out)
+    {
+        return FALSE;
+    }
+
+    linked_queue_stage_t *s = &pipeline->stages[stage];
+    out->depth = bounded_generic_queue_size(&s->input);
+    out->peak_depth = bounded_generic_queue_peak(&s->input);
+    out->processed = atomic_load(&s->processed);
+    out->dropped = atomic_load(&s->dropped);
+    out->rejected = atomic_load(&s->rejected);
+    out->busy_ns = atomic_load(&s->busy_ns);
+    return TRUE;
+}
+
+void linked_queue_pipeline_finish(linked_queue_pipeline_t *pipeline)
+{
+    if (!pipeline)
+    {
+        return;
+    }
+
+    if (pipeline->started)
+    {
+        bounded_generic_queue_close(&pipeline->stages[0].input);
+        for (size_t s = 0; s < pipeline->stage_count; s++)
+        {
+            linked_queue_stage_t *stage = &pipeline->stages[s];
+            for (size_t t = 0; t < stage->parallelism; t++)
+            {
+                pthread_join(stage->threads[t], NULL);
+            }
+
+            free(stage->threads);
+            bounded_generic_queue_free(&stage->input);
+        }
+    }
+
+    free(pipeline->stages);
+    pipeline->stages = NULL;
+    pipeline->stage_count = 0;
+    pipeline->started = FALSE;
+}
@@ -0,0 +1,113 @@
+/*
+ * This code is distributed under the terms of the GNU General Public License.
+ * For more information, please refer to the LICENSE file in the root directory.
+ * -------------------------------------------------
+ * Copyright (C) 2025 Rodrigo R.
+ * This program comes with ABSOLUTELY NO WARRANTY; for details type show w'.
+ * This is free software, and you are welcome to redistribute it
+ * under certain conditions; type show c' for details.
+*/
+
+#ifndef FLUENT_LIBC_LINKED_QUEUE_PIPELINE_H
+#define FLUENT_LIBC_LINKED_QUEUE_PIPELINE_H
+
+// ============= FLUENT LIB C =============
+// Multi-Stage Pipeline Runtime
+// ----------------------------------------
+// Runs a chain of stages (e.g. decode -> transform -> encode), each with its
+// own number of worker threads. Every stage reads from a bounded generic
+// queue, so a slow stage applies backpressure to the ones before it.
+//   - Workers take items in batches and hand their outputs to the next
+//     stage in batches, each under a single lock acquisition
+//   - A stage returns the item for the next stage, or NULL to drop it;
+//     `dropped` counts those NULLs on every stage, including the last
+//   - The value returned by the last stage is discarded
+//   - Outputs the next stage refuses (its queue was closed) are counted as
+//     `rejected` and passed to the reject callback, if set, to be released
+//   - Per-stage metrics expose queue depth, peak depth and busy time, so
+//     the bottleneck stage is the one with a full queue and high busy time
+//
+// Example:
+// ----------------------------------------
+//   linked_queue_pipeline_t pipeline;
+//   linked_queue_pipeline_init(&pipeline, 1024, 32);
+//
+//   linked_queue_pipeline_add_stage(&pipeline, decode, NULL, 1);
+//   linked_queue_pipeline_add_stage(&pipeline, transform, NULL, 4);
+//   linked_queue_pipeline_add_stage(&pipeline, encode, NULL, 1);
+//   linked_queue_pipeline_start(&pipeline);
+//
+//   while (read_frame(&frame)) {
+//       linked_queue_pipeline_push(&pipeline, frame);
+//   }
+//
+//   linked_queue_pipeline_finish(&pipeline);
+//
+
+// ============= INCLUDES =============
+#include "linked_queue.h"
+#include <stdatomic.h>
+
+typedef void *(*linked_queue_stage_fn)(void *item, void *ctx);
+typedef void (*linked_queue_reject_fn)(void *item, void *ctx);
+
+typedef struct
+{
+    size_t depth;
+    size_t peak_depth;
+    size_t processed;
+    size_t dropped;
+    size_t rejected;
+    uint64_t busy_ns;
+} linked_queue_stage_metrics_t;
+
+struct linked_queue_pipeline_t;
+
+typedef struct linked_queue_stage_t
+{
+    linked_queue_stage_fn fn;
+    void *ctx;
+    size_t parallelism;
+    bounded_generic_queue_t input;
+    pthread_t *threads;
+    atomic_size_t active;
+    atomic_size_t processed;
+    atomic_size_t dropped;
+    atomic_size_t rejected;
+    atomic_uint_fast64_t busy_ns;
+    struct linked_queue_pipeline_t *pipeline;
+    size_t index;
+} linked_queue_stage_t;
+
+typedef struct linked_queue_pipeline_t
+{
+    linked_queue_stage_t *stages;
+    size_t stage_count;
+    size_t queue_capacity;
+    size_t batch;
+    linked_queue_reject_fn on_reject;
+    void *reject_ctx;
+    bool started;
+} linked_queue_pipeline_t;
+
+/* `queue_capacity` bounds every inter-stage queue (0 = unbounded); `batch` is the handoff size */
+void linked_queue_pipeline_init(linked_queue_pipeline_t *pipeline, size_t queue_capacity, size_t batch);
+
+/* Receives every output a stage could not hand downstream; only valid before `linked_queue_pipeline_start` */
+void linked_queue_pipeline_set_reject(linked_queue_pipeline_t *pipeline, linked_queue_reject_fn fn, void *ctx);
+
+/* Appends a stage; only valid before `linked_queue_pipeline_start` */
+bool linked_queue_pipeline_add_stage(linked_queue_pipeline_t *pipeline, linked_queue_stage_fn fn, void *ctx, size_t parallelism);
+
+/* Creates the stage queues and workers; on failure nothing is left running */
+bool linked_queue_pipeline_start(linked_queue_pipeline_t *pipeline);
+
+/* Feeds an item to the first stage, blocking while its queue is full */
+bool linked_queue_pipeline_push(linked_queue_pipeline_t *pipeline, void *item);
+
+bool linked_queue_pipeline_metrics(linked_queue_pipeline_t *pipeline, size_t stage, linked_queue_stage_metrics_t *out);
+
+/* Closes the input, waits for every stage to drain and releases all resources */
+void linked_queue_pipeline_finish(linked_queue_pipeline_t *pipeline);
+
+#endif //FLUENT_LIBC_LINKED_QUEUE_PIPELINE_H